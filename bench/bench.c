@@ -0,0 +1,261 @@
+/* cJSON benchmarks. The makefile builds this once against each variant (BENCH_VARIANT names it) and runs them all.
+   Every corpus is generated here, the same bytes each run. Output is one JSON object per line:
+   {"variant","corpus","op","bytes","iters","ns_op","mb_s","allocs_op","alloc_bytes_op"}
+   allocs_op and alloc_bytes_op are the cJSON_InitHooks malloc calls per operation and the bytes they asked for.
+   Each corpus also gets a memory line, what its parsed tree holds:
+   {"variant","corpus","op":"memory","nodes","node_size","tree_bytes","bytes_node"}
+   tree_bytes is malloc_usable_size summed over the tree's live allocations, so it includes malloc's rounding.
+   Usage: bench [seconds per op, default 0.3] [corpus name to run only that one] */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include "cJSON.h"
+
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT "root"
+#endif
+
+/* Allocation counting hooks. */
+static long bench_allocs,bench_bytes,bench_live;
+static void *count_malloc(size_t sz)
+{
+	void *ptr=malloc(sz);
+	bench_allocs++;bench_bytes+=sz;
+	if (ptr) bench_live+=malloc_usable_size(ptr);
+	return ptr;
+}
+static void count_free(void *ptr) {if (ptr) bench_live-=malloc_usable_size(ptr);free(ptr);}
+
+/* Growing text for the corpus generators. */
+typedef struct text {
+	char *buf;
+	int len,size;
+} text;
+
+static void put(text *t,const char *s)
+{
+	int len=strlen(s);
+	if (t->len+len+1>t->size)
+	{
+		while (t->len+len+1>t->size) t->size=t->size?t->size*2:4096;
+		if (!(t->buf=(char*)realloc(t->buf,t->size))) {perror("realloc");exit(1);}
+	}
+	memcpy(t->buf+t->len,s,len+1);t->len+=len;
+}
+
+static unsigned long long seed=88172645463325252ULL;
+static unsigned rnd(void) {seed^=seed<<13;seed^=seed>>7;seed^=seed<<17;return (unsigned)seed;}
+
+static void put_word(text *t,int len)
+{
+	char word[64];int i;
+	for (i=0;i<len && i<63;i++) word[i]='a'+rnd()%26;
+	word[i]=0;
+	put(t,word);
+}
+
+/* Statuses shaped like a social network timeline: nested user objects, entity arrays, ids, nulls and bools. */
+static void gen_twitter(text *t)
+{
+	char num[256];int i,j,n;
+	put(t,"[");
+	for (i=0;i<2000;i++)
+	{
+		if (i) put(t,",");
+		sprintf(num,"{\"id\":%u%05u,\"created_at\":\"Mon Oct 1%d 12:%02d:00 +0000 2026\",\"text\":\"",rnd(),i,i%10,i%60);put(t,num);
+		for (j=0,n=4+rnd()%20;j<n;j++) {if (j) put(t," ");put_word(t,2+rnd()%8);}
+		put(t,"\",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":");
+		sprintf(num,"%u",rnd()%1000000);put(t,num);
+		put(t,",\"screen_name\":\"");put_word(t,8);put(t,"\",\"name\":\"");put_word(t,12);
+		sprintf(num,"\",\"followers_count\":%u,\"verified\":%s,\"lang\":\"en\"},\"entities\":{\"hashtags\":[",rnd()%100000,(rnd()&1)?"true":"false");put(t,num);
+		for (j=0,n=rnd()%4;j<n;j++) {if (j) put(t,",");put(t,"{\"text\":\"");put_word(t,6);sprintf(num,"\",\"indices\":[%d,%d]}",j*10,j*10+7);put(t,num);}
+		sprintf(num,"]},\"retweet_count\":%u,\"favorited\":false,\"geo\":null,\"score\":%.4f}",rnd()%5000,(rnd()%100000)/997.0);put(t,num);
+	}
+	put(t,"]");
+}
+
+static void gen_numbers(text *t)
+{
+	char num[64];int i;
+	put(t,"[");
+	for (i=0;i<60000;i++)
+	{
+		if (i%3) sprintf(num,"%s%u",i?",":"",rnd()%100000000);
+		else sprintf(num,"%s%.6e",i?",":"",((int)rnd()-(int)(rnd()>>1))/3.7);
+		put(t,num);
+	}
+	put(t,"]");
+}
+
+static void gen_deep(text *t)
+{
+	int i;
+	for (i=0;i<400;i++) put(t,(i&1)?"[1,":"{\"k\":");
+	put(t,"\"bottom\"");
+	for (i=399;i>=0;i--) put(t,(i&1)?"]":"}");
+}
+
+static void gen_strings(text *t)
+{
+	int i,j;
+	put(t,"[");
+	for (i=0;i<200;i++)
+	{
+		put(t,i?",\"":"\"");
+		for (j=0;j<300;j++) {put_word(t,1+rnd()%12);put(t,(j%50==49)?"\\n":(j%97==0)?"\\\"":" ");}
+		put(t,"\"");
+	}
+	put(t,"]");
+}
+
+static void gen_small(text *t)
+{
+	char num[128];int i;
+	put(t,"[");
+	for (i=0;i<20000;i++) {sprintf(num,"%s{\"id\":%d,\"ok\":%s,\"v\":\"%c%c\"}",i?",":"",i,(i&1)?"true":"false",'a'+i%26,'a'+i%7);put(t,num);}
+	put(t,"]");
+}
+
+typedef struct corpus {
+	const char *name;
+	void (*gen)(text *t);
+} corpus;
+
+static const corpus corpora[]={{"twitter",gen_twitter},{"numbers",gen_numbers},{"deep",gen_deep},{"strings",gen_strings},{"small",gen_small}};
+
+/* The workloads. Each runs one operation on the document text or its parsed tree. */
+typedef struct bench_doc {
+	const char *json;
+	cJSON *tree;
+} bench_doc;
+
+static long sink;	/* keeps results observable. */
+
+static void op_parse(bench_doc *d)				{cJSON *c=cJSON_Parse(d->json);sink+=c!=0;cJSON_Delete(c);}
+static void op_print(bench_doc *d)				{char *out=cJSON_PrintBuf(d->tree,1,0);sink+=out[0];free(out);}
+static void op_print_unformatted(bench_doc *d)	{char *out=cJSON_PrintBuf(d->tree,0,0);sink+=out[0];free(out);}
+static void op_print_view(bench_doc *d)			{int len;const char *out=cJSON_PrintView(d->tree,0,&len);sink+=out[len-1];}
+
+/* Find every member of every object by name. */
+static void lookup(cJSON *item)
+{
+	cJSON *c;
+	for (c=item->child;c;c=c->next)
+	{
+		if ((item->type&255)==cJSON_Object) sink+=cJSON_GetObjectItem(item,c->string)==c;
+		if ((c->type&255)==cJSON_Array || (c->type&255)==cJSON_Object) lookup(c);
+	}
+}
+static void op_lookup(bench_doc *d)	{if ((d->tree->type&255)==cJSON_Array || (d->tree->type&255)==cJSON_Object) lookup(d->tree);}
+
+/* Build a copy through the Create/Add calls, the way a response is put together. */
+static cJSON *build(cJSON *item)
+{
+	cJSON *copy,*c;
+	switch (item->type&255)
+	{
+		case cJSON_False:	return cJSON_CreateFalse();
+		case cJSON_True:	return cJSON_CreateTrue();
+		case cJSON_NULL:	return cJSON_CreateNull();
+		case cJSON_Number:	return cJSON_CreateNumber(cJSON_GetNumberValue(item));
+		case cJSON_String:	return cJSON_CreateString(item->valuestring);
+		case cJSON_Array:	copy=cJSON_CreateArray();for (c=item->child;c;c=c->next) cJSON_AddItemToArray(copy,build(c));return copy;
+		case cJSON_Object:	copy=cJSON_CreateObject();for (c=item->child;c;c=c->next) cJSON_AddItemToObject(copy,c->string,build(c));return copy;
+	}
+	return cJSON_CreateNull();
+}
+/* Top-level arrays are built an element at a time, as AddItemToArray walks to the end of the list. */
+static void op_build(bench_doc *d)
+{
+	cJSON *c,*copy;
+	if ((d->tree->type&255)!=cJSON_Array) {copy=build(d->tree);sink+=copy!=0;cJSON_Delete(copy);return;}
+	for (c=d->tree->child;c;c=c->next) {copy=build(c);sink+=copy!=0;cJSON_Delete(copy);}
+}
+
+/* Copying a tree: cJSON_Duplicate against a print and parse round trip. */
+static void op_duplicate(bench_doc *d)	{cJSON *c=cJSON_Duplicate(d->tree,1);sink+=c!=0;cJSON_Delete(c);}
+static void op_print_parse(bench_doc *d)	{char *out=cJSON_PrintBuf(d->tree,0,0);cJSON *c=cJSON_Parse(out);free(out);sink+=c!=0;cJSON_Delete(c);}
+
+/* One value out of the middle of a top-level array: a cursor against a full parse. */
+static void op_cursor_one(bench_doc *d)
+{
+	cJSON_Cursor cur;cJSON *c;
+	if (cJSON_Cursor_Init(&cur,d->json,-1)<0 || cJSON_Cursor_Index(&cur,cJSON_GetArraySize(d->tree)/2,&cur)<0) return;
+	c=cJSON_Cursor_Parse(&cur);sink+=c!=0;cJSON_Delete(c);
+}
+static void op_parse_one(bench_doc *d)	{cJSON *c=cJSON_Parse(d->json);sink+=cJSON_GetArrayItem(c,cJSON_GetArraySize(c)/2)!=0;cJSON_Delete(c);}
+
+typedef struct workload {
+	const char *name;
+	void (*run)(bench_doc *d);
+	int arrays_only;
+} workload;
+
+static const workload workloads[]={
+	{"parse",op_parse,0},{"print",op_print,0},{"print_unformatted",op_print_unformatted,0},{"print_view",op_print_view,0},
+	{"lookup",op_lookup,0},{"build",op_build,0},{"duplicate",op_duplicate,0},{"print_parse",op_print_parse,0},{"cursor_one",op_cursor_one,1},{"parse_one",op_parse_one,1}};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1e9+ts.tv_nsec;
+}
+
+static long count_nodes(cJSON *item)
+{
+	long n=1;cJSON *c;
+	if ((item->type&255)==cJSON_Array || (item->type&255)==cJSON_Object) for (c=item->child;c;c=c->next) n+=count_nodes(c);
+	return n;
+}
+
+/* Bytes per node of a freshly parsed tree. */
+static void memory(const char *corpus_name,const char *json)
+{
+	long live=bench_live,nodes;cJSON *c=cJSON_Parse(json);
+	live=bench_live-live;
+	nodes=count_nodes(c);
+	printf("{\"variant\":\"%s\",\"corpus\":\"%s\",\"op\":\"memory\",\"nodes\":%ld,\"node_size\":%d,\"tree_bytes\":%ld,\"bytes_node\":%.1f}\n",
+		BENCH_VARIANT,corpus_name,nodes,(int)sizeof(cJSON),live,(double)live/nodes);
+	fflush(stdout);
+	cJSON_Delete(c);
+}
+
+static void run(const char *corpus_name,bench_doc *d,int bytes,const workload *w,double seconds)
+{
+	double start,elapsed;long iters=0,allocs,alloc_bytes;
+	w->run(d);	/* warm up. */
+	allocs=bench_allocs;alloc_bytes=bench_bytes;
+	start=now_ns();
+	do {w->run(d);iters++;} while ((elapsed=now_ns()-start)<seconds*1e9 || iters<3);
+	allocs=bench_allocs-allocs;alloc_bytes=bench_bytes-alloc_bytes;
+	printf("{\"variant\":\"%s\",\"corpus\":\"%s\",\"op\":\"%s\",\"bytes\":%d,\"iters\":%ld,\"ns_op\":%.0f,\"mb_s\":%.2f,\"allocs_op\":%.1f,\"alloc_bytes_op\":%.0f}\n",
+		BENCH_VARIANT,corpus_name,w->name,bytes,iters,elapsed/iters,bytes*(double)iters/elapsed*1e9/1048576.0,(double)allocs/iters,(double)alloc_bytes/iters);
+	fflush(stdout);
+}
+
+int main(int argc,char **argv)
+{
+	double seconds=(argc>1)?atof(argv[1]):0.3;const char *only=(argc>2)?argv[2]:0;
+	cJSON_Hooks hooks;bench_doc d;text t;unsigned i,j;
+
+	hooks.malloc_fn=count_malloc;hooks.free_fn=count_free;
+	cJSON_InitHooks(&hooks);
+	for (i=0;i<sizeof(corpora)/sizeof(corpora[0]);i++)
+	{
+		if (only && strcmp(only,corpora[i].name)) continue;
+		memset(&t,0,sizeof(t));
+		corpora[i].gen(&t);
+		d.json=t.buf;
+		if (!(d.tree=cJSON_Parse(d.json))) {fprintf(stderr,"%s: corpus does not parse\n",corpora[i].name);return 1;}
+		memory(corpora[i].name,d.json);
+		for (j=0;j<sizeof(workloads)/sizeof(workloads[0]);j++)
+			if (!workloads[j].arrays_only || (d.tree->type&255)==cJSON_Array) run(corpora[i].name,&d,t.len,&workloads[j],seconds);
+		cJSON_Delete(d.tree);
+		free(t.buf);
+	}
+	return sink==-1;
+}
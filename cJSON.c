@@ -30,26 +30,279 @@
 #include <float.h>
 #include <limits.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "cJSON.h"
 
-static const char *ep;
+/* allocate_type bits: which of a node's strings it owns and must free. */
+#define Allocate_None 0
+#define Allocate_Key 1
+#define Allocate_Value 2
+#define Allocate_Inline_Key 4
+#define Allocate_Inline_Value 8
+#define Allocate_Block 16
+#define Allocate_InBlock 32
+#define Allocate_Raw_Number 64
+#define Allocate_Arena 128		/* a cJSON_ARENA parse's root: the tree's nodes and strings live in its chunks. */
+#define Allocate_Slab 256		/* a cJSON_SLAB parse's root: the tree's strings live in its allocation. */
 
-struct cJSON_Buf{
-   char * buf;
-   int len;
-   int offset;
-};
+/* Short strings live in the node itself; the compact layout has no room for them. */
+#ifndef cJSON_COMPACT
+#define INLINE_SIZE ((unsigned)sizeof(((cJSON*)0)->valueinline))
+#define inline_buf(item) ((item)->valueinline)
+#else
+#define INLINE_SIZE 0u
+#define inline_buf(item) ((char*)0)
+#endif
+
+static __thread const char *ep;
+
+/* Strings printed by reference for cJSON_PrintIov: data goes between the buffer text before and after offset. */
+typedef struct iov_ref {
+	int offset;
+	const char *data;
+	int len;
+} iov_ref;
+
+typedef struct iov_refs {
+	iov_ref *refs;
+	int count,size,min_ref;
+} iov_refs;
+
+/* Set only while cJSON_PrintIov prints. */
+static __thread iov_refs *print_refs;
+
+/* Allocation counters, per thread. */
+#ifdef cJSON_ALLOC_STATS
+#include <malloc.h>
+static __thread cJSON_AllocStats alloc_stats;
+#define count_grow(buf) (alloc_stats.buf_grows++,alloc_stats.buf_copied+=(buf)->offset)
+#else
+#define count_grow(buf) ((void)0)
+#endif
+
+/* Latency histograms, per thread, and the trace hook. Times are CLOCK_MONOTONIC nanoseconds, which need no calibration.
+   Each histogram is log-linear like an HDR histogram: exact below 16ns, then 8 buckets per power of two, so a bucket is
+   within 12.5% of what it counts. */
+#ifdef cJSON_TRACE
+#include <time.h>
+static long long trace_now(void) {struct timespec ts;clock_gettime(CLOCK_MONOTONIC,&ts);return ts.tv_sec*1000000000LL+ts.tv_nsec;}
+
+#define TRACE_BUCKETS (16+60*8)
+
+/* One thread's histograms. Blocks are never freed: the counts of a thread that has gone stay in the snapshots. */
+typedef struct trace_block {
+	struct trace_block *next;
+	unsigned long long counts[cJSON_TRACE_TYPES][cJSON_Trace_Phases][TRACE_BUCKETS];
+} trace_block;
+
+static trace_block *trace_blocks;			/* every thread's, pushed on first use. */
+static __thread trace_block *trace_local;
+static __thread int trace_type;
+static __thread int trace_parsing;			/* in cJSON_Parse: time the allocations. */
+static __thread long long trace_alloc;		/* ns spent in them. */
+static cJSON_TraceHook trace_hook;
+static void *trace_hook_ctx;
+
+static int trace_bucket(long long ns)
+{
+	int e;
+	if (ns<16) return ns<0?0:(int)ns;
+	e=63-__builtin_clzll((unsigned long long)ns);
+	return 16+(e-4)*8+(int)((ns>>(e-3))&7);
+}
+
+/* The middle of bucket i, in nanoseconds. */
+static double trace_value(int i)
+{
+	int e;
+	if (i<16) return i;
+	e=(i-16)/8+4;
+	return (double)(8+(i-16)%8)*(1LL<<(e-3))+(1LL<<(e-3))/2.0;
+}
+
+static void trace_record(int phase,long long ns)
+{
+	trace_block *block=trace_local;unsigned long long *count;
+	if (!block)
+	{
+		if (!(block=(trace_block*)calloc(1,sizeof(trace_block)))) return;	/* memory fail */
+		do block->next=__atomic_load_n(&trace_blocks,__ATOMIC_RELAXED); while (!__sync_bool_compare_and_swap(&trace_blocks,block->next,block));
+		trace_local=block;
+	}
+	count=&block->counts[trace_type][phase][trace_bucket(ns)];
+	__atomic_store_n(count,*count+1,__ATOMIC_RELAXED);	/* only this thread writes it. */
+	if (trace_hook) trace_hook(phase,trace_type,ns,trace_hook_ctx);
+}
+
+#define trace_start() trace_now()
+#define trace_end(phase,start) trace_record(phase,trace_now()-(start))
+#define trace_alloc_start() (trace_parsing?trace_now():0)
+#define trace_alloc_end(start) (trace_parsing?(void)(trace_alloc+=trace_now()-(start)):(void)0)
+#define trace_parse_begin() (trace_parsing=1,trace_alloc=0)
+#define trace_parse_end(ok) (trace_parsing=0,(ok)?trace_record(cJSON_Trace_ParseAlloc,trace_alloc):(void)0)
+
+void cJSON_TraceSetType(int type) {trace_type=(type>=0 && type<cJSON_TRACE_TYPES)?type:0;}
+void cJSON_SetTraceHook(cJSON_TraceHook hook,void *ctx) {trace_hook_ctx=ctx;trace_hook=hook;}
+
+int cJSON_TraceSnapshot(int type,int phase,cJSON_TraceStats *stats)
+{
+	trace_block *block;unsigned long long counts[TRACE_BUCKETS],total=0,seen=0,want[3];double *out[3];int i,j=0,top=-1;
+	memset(stats,0,sizeof(cJSON_TraceStats));
+	if (type<0 || type>=cJSON_TRACE_TYPES || phase<0 || phase>=cJSON_Trace_Phases) return -1;
+	for (i=0;i<TRACE_BUCKETS;i++)
+	{
+		unsigned long long n=0;
+		for (block=__atomic_load_n(&trace_blocks,__ATOMIC_ACQUIRE);block;block=block->next) n+=__atomic_load_n(&block->counts[type][phase][i],__ATOMIC_RELAXED);
+		counts[i]=n;total+=n;
+		if (n) top=i;
+	}
+	if (!total) return 0;
+	want[0]=(total+1)/2;want[1]=total-total/100;want[2]=total-total/1000;
+	out[0]=&stats->p50;out[1]=&stats->p99;out[2]=&stats->p999;
+	for (i=0;i<TRACE_BUCKETS && j<3;i++)
+		for (seen+=counts[i];j<3 && seen>=want[j];j++) *out[j]=trace_value(i);
+	stats->count=total;
+	stats->max=trace_value(top);
+	return 0;
+}
+#else
+#define trace_start() 0
+#define trace_end(phase,start) ((void)(start))
+#define trace_alloc_start() 0
+#define trace_alloc_end(start) ((void)(start))
+#define trace_parse_begin() ((void)0)
+#define trace_parse_end(ok) ((void)0)
+
+void cJSON_TraceSetType(int type) {}
+void cJSON_SetTraceHook(cJSON_TraceHook hook,void *ctx) {}
+int cJSON_TraceSnapshot(int type,int phase,cJSON_TraceStats *stats) {memset(stats,0,sizeof(cJSON_TraceStats));return -1;}
+#endif
+
+const char *cJSON_GetErrorPtr() {return ep;}
+
+static int BKDRHash(const char *key){
+     unsigned int seed =131;  //  31 131 1313 13131 131313 etc..
+     unsigned int hash =0 ;
+     while(*key){
+         hash=hash*seed+(*key++);
+     }
+     return hash&0x7fffffff;
+}
+
+static int cJSON_strcasecmp(const char *s1,const char *s2)
+{
+	if (!s1) return (s1==s2)?0:1;if (!s2) return 1;
+	for(; tolower(*s1) == tolower(*s2); ++s1, ++s2)	if(*s1 == 0)	return 0;
+	return tolower(*(const unsigned char *)s1) - tolower(*(const unsigned char *)s2);
+}
+
+static void *(*hook_malloc)(size_t sz) = malloc;
+static void (*hook_free)(void *ptr) = free;
+
+void cJSON_InitHooks(cJSON_Hooks* hooks)
+{
+    if (!hooks) { /* Reset hooks */
+        hook_malloc = malloc;
+        hook_free = free;
+        return;
+    }
+
+	hook_malloc = (hooks->malloc_fn)?hooks->malloc_fn:malloc;
+	hook_free	 = (hooks->free_fn)?hooks->free_fn:free;
+}
+
+#ifndef cJSON_ALLOC_STATS
+#define count_alloc(ptr) ((void)0)
+#define count_free(ptr) ((void)0)
+
+int cJSON_GetAllocStats(cJSON_AllocStats *stats) {memset(stats,0,sizeof(cJSON_AllocStats));return -1;}
+void cJSON_ResetAllocStats(void) {}
+char *cJSON_PrintAllocStats(void) {return 0;}
+#else
+/* Bytes are what malloc_usable_size reports, so they are only kept with the default malloc and free. */
+static void count_alloc(void *ptr)
+{
+	alloc_stats.allocs++;
+	if (hook_malloc==malloc)
+	{
+		alloc_stats.bytes_live+=malloc_usable_size(ptr);
+		if (alloc_stats.bytes_live>alloc_stats.bytes_peak) alloc_stats.bytes_peak=alloc_stats.bytes_live;
+	}
+}
+
+static void count_free(void *ptr)
+{
+	alloc_stats.frees++;
+	if (hook_free==free) alloc_stats.bytes_live-=malloc_usable_size(ptr);
+}
+
+int cJSON_GetAllocStats(cJSON_AllocStats *stats) {*stats=alloc_stats;return 0;}
+void cJSON_ResetAllocStats(void) {memset(&alloc_stats,0,sizeof(alloc_stats));}
+
+char *cJSON_PrintAllocStats(void)
+{
+	char *out=(char*)hook_malloc(256);	/* not counted, so the counters are as they were. */
+	if (!out) return 0;
+	sprintf(out,"{\"allocs\":%ld,\"frees\":%ld,\"bytes_live\":%ld,\"bytes_peak\":%ld,\"buf_grows\":%ld,\"buf_copied\":%ld}",
+		alloc_stats.allocs,alloc_stats.frees,alloc_stats.bytes_live,alloc_stats.bytes_peak,alloc_stats.buf_grows,alloc_stats.buf_copied);
+	return out;
+}
+#endif
+
+/* Straight through to the hooks unless allocations are counted or timed. */
+#if !defined(cJSON_ALLOC_STATS) && !defined(cJSON_TRACE)
+#define cJSON_malloc(sz) hook_malloc(sz)
+#define cJSON_free(ptr) hook_free(ptr)
+#else
+static void *cJSON_malloc(size_t sz)
+{
+	long long start=trace_alloc_start();
+	void *ptr=hook_malloc(sz);
+	trace_alloc_end(start);
+	if (ptr) count_alloc(ptr);
+	return ptr;
+}
+
+static void cJSON_free(void *ptr)
+{
+	if (!ptr) return;
+	count_free(ptr);
+	hook_free(ptr);
+}
+#endif
+
+/* Resize ptr (size bytes) to new_size through the hooks. With the default ones this is realloc, which can grow in place. */
+static void *cJSON_realloc(void *ptr,size_t size,size_t new_size)
+{
+	void *grown;
+	if (hook_malloc==malloc && hook_free==free)
+	{
+		if (ptr) count_free(ptr);
+		if (!(grown=realloc(ptr,new_size))) {if (ptr) count_alloc(ptr);return 0;}
+		count_alloc(grown);
+		return grown;
+	}
+	if (!(grown=cJSON_malloc(new_size))) return 0;
+	if (ptr) {memcpy(grown,ptr,size<new_size?size:new_size);cJSON_free(ptr);}
+	return grown;
+}
 
-int cJSON_Buf_Init(cJSON_Buf & buf, int size,int padding){
-	buf.len = size+padding;
-	buf.offset= padding;
-	buf.buf = (char*)malloc(buf.len);
-	if(!buf.buf)return -1;
+int cJSON_Buf_Init(cJSON_Buf * buf, int size,int offset){
+	buf->len = size;
+	buf->offset= offset;
+	buf->buf = (char*)cJSON_malloc(buf->len);
+	if(!buf->buf)return -1;
 	return 0;
 }
 
-void cJSON_Buf_Clear(cJSON_Buf & buf){
-	if(buf.buf)free(buf.buf);
+void cJSON_Buf_Clear(cJSON_Buf * buf){
+	if(buf->buf)cJSON_free(buf->buf);
+	buf->len = 0;
+	buf->offset= 0;
 }
 
 int cJSON_Buf_Check(cJSON_Buf*buf, int len){
@@ -61,11 +314,12 @@ int cJSON_Buf_Check(cJSON_Buf*buf, int len){
 		new_size*=2;
 	}
 	
-    new_ptr = (char*)realloc(buf->buf, new_size);
+    new_ptr = (char*)cJSON_realloc(buf->buf, buf->len, new_size);
     if(!new_ptr){
         return -1;
     }
 
+    count_grow(buf);
     buf->buf = new_ptr;
     buf->len = new_size;
 	return 0;
@@ -85,74 +339,217 @@ char* cJSON_Buf_Copy_Char(cJSON_Buf*buf,char ch){
 	return buf->buf;
 }
 
-const char *cJSON_GetErrorPtr() {return ep;}
+char* cJSON_Buf_Copy_Mem(cJSON_Buf*buf,const char * mem,int len){
+	if(cJSON_Buf_Check(buf,len)<0)return 0;
+	memcpy(buf->buf + buf->offset,mem,len);
+	buf->offset +=len;
+	return buf->buf;
+}
 
-static int BKDRHash(const char *key){
-     unsigned int seed =131;  //  31 131 1313 13131 131313 etc..
-     unsigned int hash =0 ;
-     while(*key){
-         hash=hash*seed+(*key++);
-     }
-     return hash&0x7fffffff;
+/* How deep parse and print will nest before giving up. */
+static int nesting_limit=cJSON_NESTING_LIMIT;
+
+void cJSON_SetNestingLimit(int depth)
+{
+	nesting_limit=(depth>0)?depth:cJSON_NESTING_LIMIT;
 }
 
-static int cJSON_strcasecmp(const char *s1,const char *s2)
+/* Internal constructor. */
+static cJSON *cJSON_New_Item()
 {
-	if (!s1) return (s1==s2)?0:1;if (!s2) return 1;
-	for(; tolower(*s1) == tolower(*s2); ++s1, ++s2)	if(*s1 == 0)	return 0;
-	return tolower(*(const unsigned char *)s1) - tolower(*(const unsigned char *)s2);
+	cJSON* node = (cJSON*)cJSON_malloc(sizeof(cJSON));
+	if (node)
+	{
+		memset(node,0,sizeof(cJSON));
+		node->hash_string =-1;
+		node->allocate_type=Allocate_None;
+	}
+	return node;
 }
 
-static void *(*cJSON_malloc)(size_t sz) = malloc;
-static void (*cJSON_free)(void *ptr) = free;
+/* A key can only go inline where the value does not: containers, nulls and strings stored elsewhere. */
+#define inline_free(item) (((item)->type&255)==cJSON_Array || ((item)->type&255)==cJSON_Object || ((item)->type&255)==cJSON_NULL || ((((item)->type&255)==cJSON_String || ((item)->type&255)==cJSON_Raw) && !((item)->allocate_type&Allocate_Inline_Value)))
 
-static char* cJSON_strdup(const char* str)
+/* Give item its own copy of string as key. Returns 0, or -1 on memory fail (the key is then 0). */
+static int set_key(cJSON *item,const char *string)
 {
-      size_t len;
-      char* copy;
+	char *old=(item->allocate_type&Allocate_Key)?item->string:0,*copy;int len=strlen(string),flag=Allocate_Key;
+	if ((unsigned)len<INLINE_SIZE && inline_free(item)) {copy=inline_buf(item);memmove(copy,string,len+1);flag=Allocate_Inline_Key;}
+	else if ((copy=(char*)cJSON_malloc(len+1))) memcpy(copy,string,len+1);
+	else flag=0;
+	if (old) cJSON_free(old);
+	item->string=copy;item->hash_string=-1;
+	item->allocate_type=(item->allocate_type&~(Allocate_Key|Allocate_Inline_Key))|flag;
+	return copy?0:-1;
+}
 
-      len = strlen(str) + 1;
-      if (!(copy = (char*)cJSON_malloc(len))) return 0;
-      memcpy(copy,str,len);
-      return copy;
+/* Hand item a key to free later (owned) or to leave alone. */
+static void adopt_key(cJSON *item,char *string,int owned)
+{
+	if ((item->allocate_type&Allocate_Key) && item->string!=string) cJSON_free(item->string);
+	item->string=string;item->hash_string=-1;
+	item->allocate_type=(item->allocate_type&~(Allocate_Key|Allocate_Inline_Key))|(owned?Allocate_Key:0);
 }
 
-void cJSON_InitHooks(cJSON_Hooks* hooks)
+/* Give a fresh string item its own copy of the len bytes at string as value. Returns 0, or -1 on memory fail. */
+static int set_valuestring(cJSON *item,const char *string,int len)
 {
-    if (!hooks) { /* Reset hooks */
-        cJSON_malloc = malloc;
-        cJSON_free = free;
-        return;
-    }
+	if ((unsigned)len<INLINE_SIZE && !(item->allocate_type&Allocate_Inline_Key)) {item->valuestring=inline_buf(item);item->allocate_type|=Allocate_Inline_Value;}
+	else if ((item->valuestring=(char*)cJSON_malloc(len+1))) item->allocate_type|=Allocate_Value;
+	else return -1;
+	memcpy(item->valuestring,string,len);item->valuestring[len]=0;
+	return 0;
+}
+
+/* Utility for array list handling. Without prev links the predecessor is found by walking from the parent. */
+#ifndef cJSON_NO_PREV
+#define set_prev(item,p) ((item)->prev=(p))
+static cJSON *prev_item(cJSON *parent,cJSON *c) {return c->prev;}
+#else
+#define set_prev(item,p) ((void)0)
+static cJSON *prev_item(cJSON *parent,cJSON *c) {cJSON *p=parent->child;if (p==c) return 0;while (p && p->next!=c) p=p->next;return p;}
+#endif
+static void suffix_object(cJSON *prev,cJSON *item) {prev->next=item;set_prev(item,prev);}
+
+/* Numbers keep the int/uint copies only in the full layout. */
+#ifndef cJSON_COMPACT
+#define set_true(item) ((item)->valueint=1)
+static void set_number(cJSON *item,double num) {item->valuedouble=num;item->valueint=(int)num;item->valueuint=(uint)num;}
+#else
+#define set_true(item) ((void)0)
+static void set_number(cJSON *item,double num) {item->valuedouble=num;}
+#endif
+
+/* Print cache: the text of a subtree, unformatted and formatted (which depends on the depth it was printed at).
+   Print records where the text starts, stores it when the container closes, and sets the parent links invalidation climbs. */
+#ifdef cJSON_PRINT_CACHE
+typedef struct cJSON_PrintCache cJSON_PrintCache;
+struct cJSON_PrintCache {
+	char *text[2];
+	int len[2];
+	int depth;		/* of text[1]. */
+	int start;		/* offset of the text being printed. */
+};
 
-	cJSON_malloc = (hooks->malloc_fn)?hooks->malloc_fn:malloc;
-	cJSON_free	 = (hooks->free_fn)?hooks->free_fn:free;
+#define set_parent(c,p) ((c)->parent=(p))
+#define clear_cache(c) ((c)->parent=0,(c)->cache=0)
+/* Print links parents only inside cached containers, and only where they changed: a tree without caches prints read-only. */
+#define is_cached(c) ((c)->cache!=0)
+#define link_parent(c,p) do {if ((c)->parent!=(p)) (c)->parent=(p);} while (0)
+
+static void cache_drop(cJSON_PrintCache *cache)
+{
+	if (cache->text[0]) cJSON_free(cache->text[0]);
+	if (cache->text[1]) cJSON_free(cache->text[1]);
+	cache->text[0]=cache->text[1]=0;
 }
 
-/* Internal constructor. */
-static cJSON *cJSON_New_Item()
+int cJSON_SetPrintCache(cJSON *item,int enable)
 {
-	cJSON* node = (cJSON*)cJSON_malloc(sizeof(cJSON));
-	if (node) memset(node,0,sizeof(cJSON));
-	node->hash_string =-1;
-	return node;
+	if (!item || ((item->type&255)!=cJSON_Array && (item->type&255)!=cJSON_Object)) return -1;
+	if (!enable)
+	{
+		if (item->cache) {cache_drop(item->cache);cJSON_free(item->cache);item->cache=0;}
+		return 0;
+	}
+	if (!item->cache && !(item->cache=(cJSON_PrintCache*)cJSON_malloc(sizeof(cJSON_PrintCache)))) return -1;	/* memory fail */
+	memset(item->cache,0,sizeof(cJSON_PrintCache));
+	return 0;
 }
 
-/* Delete a cJSON structure. */
-void cJSON_Delete(cJSON *c)
+void cJSON_InvalidatePrintCache(cJSON *item)
+{
+	for (;item;item=item->parent) if (item->cache) cache_drop(item->cache);
+}
+
+/* Copy item's cached text for this format and depth. Returns 1 if copied, 0 if item has to be printed, -1 on memory fail. */
+static int cache_print(cJSON *item,int depth,int fmt,cJSON_Buf *buf)
+{
+	cJSON_PrintCache *cache=item->cache;
+	if (!cache) return 0;
+	if (cache->text[fmt] && (!fmt || cache->depth==depth)) return cJSON_Buf_Copy_Mem(buf,cache->text[fmt],cache->len[fmt])?1:-1;
+	cache->start=buf->offset;
+	return 0;
+}
+
+/* item has just closed; keep its text. Failing to is not an error, it stays uncached. */
+static void cache_store(cJSON *item,int depth,int fmt,cJSON_Buf *buf)
+{
+	cJSON_PrintCache *cache=item->cache;int len;char *text;
+	if (!cache) return;
+	if (print_refs && print_refs->count && print_refs->refs[print_refs->count-1].offset>=cache->start) return;	/* text has holes. */
+	len=buf->offset-cache->start;
+	if (!(text=(char*)cJSON_malloc(len))) return;
+	memcpy(text,buf->buf+cache->start,len);
+	if (cache->text[fmt]) cJSON_free(cache->text[fmt]);
+	cache->text[fmt]=text;cache->len[fmt]=len;
+	if (fmt) cache->depth=depth;
+}
+#else
+#define set_parent(c,p) ((void)0)
+#define clear_cache(c) ((void)0)
+#define is_cached(c) 0
+#define link_parent(c,p) ((void)0)
+int cJSON_SetPrintCache(cJSON *item,int enable) {return -1;}
+void cJSON_InvalidatePrintCache(cJSON *item) {}
+static int cache_print(cJSON *item,int depth,int fmt,cJSON_Buf *buf) {return 0;}
+static void cache_store(cJSON *item,int depth,int fmt,cJSON_Buf *buf) {}
+#endif
+
+static void shared_release(cJSON *handle);
+
+/* Delete a cJSON structure. Going down, a container's child pointer is reused to point at its parent, so any depth is freed without recursing.
+   Nodes inside a cJSON_Duplicate block are left for the block's owner, which comes after them. */
+#ifdef cJSON_ARENA
+static void arena_free(cJSON *root);
+#define free_node(c) (((c)->allocate_type&Allocate_Arena)?arena_free(c):((c)->allocate_type&Allocate_InBlock)?(void)0:cJSON_free(c))
+#else
+#define free_node(c) (((c)->allocate_type&Allocate_InBlock)?(void)0:cJSON_free(c))
+#endif
+
+/* Untimed, for the deletes inside calls that are timed themselves. */
+static void delete_tree(cJSON *c)
 {
-	cJSON *next;
+	cJSON *next,*parent=0;
 	while (c)
 	{
+		if (!(c->type&cJSON_IsReference) && ((c->type&255)==cJSON_Array || (c->type&255)==cJSON_Object) && c->child)
+		{
+			next=c->child;
+			c->child=parent;parent=c;
+			c=next;
+			continue;
+		}
 		next=c->next;
-		if (!(c->type&cJSON_IsReference) && c->child) cJSON_Delete(c->child);
-		if (!(c->type&cJSON_IsReference) && c->valuestring) cJSON_free(c->valuestring);
-		if (c->string) cJSON_free(c->string);
-		cJSON_free(c);
+		if (!(c->type&cJSON_IsReference) && ((c->type&255)==cJSON_String || (c->type&255)==cJSON_Raw || (c->allocate_type&Allocate_Raw_Number)) && (c->allocate_type&Allocate_Value) && c->valuestring) cJSON_free(c->valuestring);
+		if (c->type&cJSON_IsShared) shared_release(c);
+#ifdef cJSON_PRINT_CACHE
+		if (c->cache) cJSON_SetPrintCache(c,0);
+#endif
+		if ((c->allocate_type&Allocate_Key) && c->string) cJSON_free(c->string);
+		free_node(c);
+		while (!next && parent)
+		{	/* last child gone, the parent is next. */
+			c=parent;parent=c->child;next=c->next;
+			if ((c->allocate_type&Allocate_Key) && c->string) cJSON_free(c->string);
+#ifdef cJSON_PRINT_CACHE
+			if (c->cache) cJSON_SetPrintCache(c,0);
+#endif
+			free_node(c);
+		}
 		c=next;
 	}
 }
 
+void cJSON_Delete(cJSON *c)
+{
+	long long start;
+	if (!c) return;
+	start=trace_start();
+	delete_tree(c);
+	trace_end(cJSON_Trace_Delete,start);
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
 static const char *parse_number(cJSON *item,const char *num)
 {
@@ -170,25 +567,94 @@ static const char *parse_number(cJSON *item,const char *num)
 
 	n=sign*n*pow(10.0,(scale+subscale*signsubscale));	/* number = +/- number.fraction * 10^+/- exponent */
 	
-	item->valuedouble=n;
-	item->valueint=(int)n;
-	item->valueuint=(uint)n;
+	set_number(item,n);
 	item->type=cJSON_Number;
 	return num;
 }
 
-/* Render the number nicely from the given item into a string. */
-static char *print_number(cJSON *item,cJSON_Buf* buf)
+/* Jump the text parse_number would read. */
+static const char *skip_number(const char *num)
+{
+	if (*num=='-') num++;
+	if (*num=='0') num++;
+	if (*num>='1' && *num<='9')	do num++; while (*num>='0' && *num<='9');
+	if (*num=='.') {num++;		do num++; while (*num>='0' && *num<='9');}
+	if (*num=='e' || *num=='E')
+	{	num++;if (*num=='+' || *num=='-') num++;
+		while (*num>='0' && *num<='9') num++;
+	}
+	return num;
+}
+
+/* Raw numbers only keep their text: point at it and leave the conversion to cJSON_GetNumberValue. */
+static __thread int parse_options;
+/* Filled in as cJSON_ParseWithStats goes. */
+static __thread cJSON_ParseStats *parse_stats;
+/* The nesting depth parse_value starts at: 1 in cJSON_ParseParallel's workers, which parse elements of the top-level array. */
+static __thread int parse_depth;
+
+static const char *parse_raw_number(cJSON *item,const char *num)
+{
+	item->valuestring=(char*)num;
+	item->type=cJSON_Number;
+	item->allocate_type|=Allocate_Raw_Number;
+	return skip_number(num);
+}
+
+double cJSON_GetNumberValue(cJSON *item)
+{
+	cJSON number;
+	if (!(item->allocate_type&Allocate_Raw_Number)) return item->valuedouble;
+	parse_number(&number,item->valuestring);
+	return number.valuedouble;
+}
+
+void cJSON_SetNumberValue(cJSON *item,double num)
+{
+	if (item->allocate_type&Allocate_Raw_Number)
+	{
+		if (item->allocate_type&Allocate_Value) cJSON_free(item->valuestring);	/* a duplicate's own copy of the text. */
+		item->valuestring=0;item->allocate_type&=~(Allocate_Raw_Number|Allocate_Value);
+	}
+	set_number(item,num);
+	cJSON_InvalidatePrintCache(item);
+}
+
+/* string may be the item's own text or part of it, so it is moved, and the old copy freed last. */
+int cJSON_SetValuestring(cJSON *item,const char *string)
+{
+	char *old,*copy;int len;
+	if (!item || !string || (item->type&255)!=cJSON_String || (item->type&cJSON_IsReference)) return -1;
+	old=(item->allocate_type&Allocate_Value)?item->valuestring:0;
+	len=strlen(string);
+	if ((unsigned)len<INLINE_SIZE && !(item->allocate_type&Allocate_Inline_Key))
+	{
+		copy=inline_buf(item);memmove(copy,string,len+1);
+		item->allocate_type=(item->allocate_type&~Allocate_Value)|Allocate_Inline_Value;
+	}
+	else
+	{
+		if (!(copy=(char*)cJSON_malloc(len+1))) return -1;	/* memory fail */
+		memcpy(copy,string,len+1);
+		item->allocate_type=(item->allocate_type&~Allocate_Inline_Value)|Allocate_Value;
+	}
+	item->valuestring=copy;
+	if (old) cJSON_free(old);
+	cJSON_InvalidatePrintCache(item);
+	return 0;
+}
+
+/* Render the number nicely into a string. */
+static char *print_double(double d,cJSON_Buf* buf)
 {
 	char str[64];
-	double d=item->valuedouble;
-	if (fabs(((double)item->valueint)-d)<=DBL_EPSILON && d<=INT_MAX && d>=INT_MIN)
+	if (d<=INT_MAX && d>=INT_MIN && fabs(((double)(int)d)-d)<=DBL_EPSILON)
 	{
-		sprintf(str,"%d",item->valueint);
+		sprintf(str,"%d",(int)d);
 	}
 	else
 	{
-		if (fabs(floor(d)-d)<=DBL_EPSILON)			sprintf(str,"%.0f",d);
+		if (fabs(floor(d)-d)<=DBL_EPSILON && fabs(d)<1.0e60)	sprintf(str,"%.0f",d);	/* larger ones would not fit str. */
 		else if (fabs(d)<1.0e-6 || fabs(d)>1.0e9)	sprintf(str,"%e",d);
 		else										sprintf(str,"%f",d);
 	}
@@ -196,25 +662,48 @@ static char *print_number(cJSON *item,cJSON_Buf* buf)
 	return buf->buf;
 }
 
+static char *print_number(cJSON *item,cJSON_Buf* buf)
+{
+	if (item->allocate_type&Allocate_Raw_Number) return cJSON_Buf_Copy_Mem(buf,item->valuestring,skip_number(item->valuestring)-item->valuestring);
+	return print_double(item->valuedouble,buf);
+}
+
+static unsigned parse_hex4(const char *str)
+{
+	unsigned h=0;
+	int len =4 ;
+	while(len--){
+		h=h<<4;
+		if (*str>='0' && *str<='9') h+=(*str)-'0'; 
+		else if (*str>='A' && *str<='F') h+=10+(*str)-'A'; 
+		else if (*str>='a' && *str<='f') h+=10+(*str)-'a'; 
+		else return 0x10000;
+		str++;
+	}
+	return h;
+}
+
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
-static const char *parse_string(cJSON *item,const char *str)
+/* Roughly how long the unescaped string at str (on its opening quote) will be, never less. */
+static int string_length(const char *str)
 {
-	const char *ptr=str+1;char *ptr2;char *out;int len=0;unsigned uc;
-	if (*str!='\"') {ep=str;return 0;}	/* not a string! */
-	
-	while (*ptr!='\"' && *ptr && ++len) if (*ptr++ == '\\') ptr++;	/* Skip escaped quotes. */
-	
-	out=(char*)cJSON_malloc(len+1);	/* This is how long we need for the string, roughly. */
-	if (!out) return 0;
-	
-	ptr=str+1;ptr2=out;
+	const char *ptr=str+1;int len=0;
+	while (*ptr!='\"' && *ptr && ++len) if (*ptr++ == '\\' && *ptr) ptr++;	/* Skip escaped quotes. */
+	return len;
+}
+
+/* Unescape the string at str into out, which has room for string_length()+1 bytes. Returns the end of the string. */
+static const char *unescape_string(const char *str,char *out,int *outlen)
+{
+	const char *ptr=str+1;char *ptr2=out;int len;unsigned uc;
 	while (*ptr!='\"' && *ptr)
 	{
 		if (*ptr!='\\') *ptr2++=*ptr++;
 		else
 		{
 			ptr++;
+			if (!*ptr) break;	/* a backslash ending the text. */
 			switch (*ptr)
 			{
 				case 'b': *ptr2++='\b';	break;
@@ -223,7 +712,7 @@ static const char *parse_string(cJSON *item,const char *str)
 				case 'r': *ptr2++='\r';	break;
 				case 't': *ptr2++='\t';	break;
 				case 'u':	 /* transcode utf16 to utf8. DOES NOT SUPPORT SURROGATE PAIRS CORRECTLY. */
-					sscanf(ptr+1,"%4x",&uc);	/* get the unicode char. */
+					uc=0;sscanf(ptr+1,"%4x",&uc);	/* get the unicode char. */
 					len=3;if (uc<0x80) len=1;else if (uc<0x800) len=2;ptr2+=len;
 					
 					switch (len) {
@@ -231,7 +720,7 @@ static const char *parse_string(cJSON *item,const char *str)
 						case 2: *--ptr2 =((uc | 0x80) & 0xBF); uc >>= 6;
 						case 1: *--ptr2 =(uc | firstByteMark[len]);
 					}
-					ptr2+=len;ptr+=4;
+					ptr2+=len;for (len=0;len<4 && ptr[1];len++) ptr++;	/* up to 4 hex digits, never past the end of the text. */
 					break;
 				default:  *ptr2++=*ptr; break;
 			}
@@ -239,271 +728,2234 @@ static const char *parse_string(cJSON *item,const char *str)
 		}
 	}
 	*ptr2=0;
+	if (outlen) *outlen=ptr2-out;
 	if (*ptr=='\"') ptr++;
-	item->valuestring=out;
-	item->type=cJSON_String;
 	return ptr;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
-static char *print_string_ptr(const char *str,cJSON_Buf* buf)
+#ifdef cJSON_ARENA
+/* Arena parse: cJSON_Parse takes the document's nodes and strings from chunks chained behind the root, each twice the last up to
+   ARENA_MAX, and frees them all with the root. The nodes are marked Allocate_InBlock, so as in a Duplicate block an item
+   detached from the tree must not outlive it, and the memory of items deleted from it only comes back with the root. */
+typedef struct arena_chunk {
+	struct arena_chunk *next;
+	size_t size;
+} arena_chunk;
+
+#define ARENA_FIRST 4096
+#define ARENA_MAX (1024*1024)
+
+static __thread arena_chunk *arena_last;	/* set while cJSON_Parse runs. */
+static __thread char *arena_next,*arena_end;
+
+static cJSON *new_root(const char *value)
 {
-	const char *ptr=str;unsigned char token;char*out=0;
-	char temp[6];
-	if(!cJSON_Buf_Copy_Char(buf,'\"'))return 0;
-	
-	while (*ptr)
+	arena_chunk *chunk=(arena_chunk*)cJSON_malloc(ARENA_FIRST);cJSON *node;
+	if (!chunk) return 0;
+	chunk->next=0;chunk->size=ARENA_FIRST;
+	node=(cJSON*)(chunk+1);
+	memset(node,0,sizeof(cJSON));
+	node->hash_string=-1;node->allocate_type=Allocate_Arena;
+	arena_last=chunk;arena_next=(char*)(node+1);arena_end=(char*)chunk+ARENA_FIRST;
+	return node;
+}
+#define end_slab() (arena_last=0,arena_next=arena_end=0)
+
+/* size bytes, kept to 8 byte multiples so nodes stay aligned; 0 on memory fail. */
+static void *arena_alloc(size_t size)
+{
+	arena_chunk *chunk;size_t bytes;void *out;
+	size=(size+7)&~(size_t)7;
+	if ((size_t)(arena_end-arena_next)<size)
 	{
-		if ((unsigned char)*ptr>31 && *ptr!='\"' && *ptr!='\\') out=cJSON_Buf_Copy_Char(buf,*ptr++);
-		else
-		{
-			if(!cJSON_Buf_Copy_Char(buf,'\\'))return 0;
-			switch (token=*ptr++)
-			{
-				case '\\':	out=cJSON_Buf_Copy_Char(buf,'\\');break;
-				case '\"':	out=cJSON_Buf_Copy_Char(buf,'\"');break;
-				case '\b':	out=cJSON_Buf_Copy_Char(buf,'b');break;
-				case '\f':	out=cJSON_Buf_Copy_Char(buf,'f');break;
-				case '\n':	out=cJSON_Buf_Copy_Char(buf,'n');break;
-				case '\r':	out=cJSON_Buf_Copy_Char(buf,'r');break;
-				case '\t':	out=cJSON_Buf_Copy_Char(buf,'t');break;
-				default: sprintf(temp,"u%04x",token);out=cJSON_Buf_Copy_Str(buf,temp);break;	/* escape and print */
-			}
-		}
-		if(!out)return 0;
+		bytes=arena_last->size*2;
+		if (bytes>ARENA_MAX) bytes=ARENA_MAX;
+		if (bytes<size+sizeof(arena_chunk)) bytes=size+sizeof(arena_chunk);
+		if (!(chunk=(arena_chunk*)cJSON_malloc(bytes))) return 0;
+		chunk->next=0;chunk->size=bytes;
+		arena_last->next=chunk;arena_last=chunk;
+		arena_next=(char*)(chunk+1);arena_end=(char*)chunk+bytes;
 	}
-	if(!cJSON_Buf_Copy_Char(buf,'\"'))return 0;
-	return buf->buf;
+	out=arena_next;arena_next+=size;
+	return out;
 }
-/* Invote print_string_ptr (which is useful) on an item. */
-static char *print_string(cJSON *item,cJSON_Buf* buf)	{return print_string_ptr(item->valuestring,buf);}
-
-/* Predeclare these prototypes. */
-static const char *parse_value(cJSON *item,const char *value);
-static char *print_value(cJSON *item,int depth,int fmt,cJSON_Buf* buf);
-static const char *parse_array(cJSON *item,const char *value);
-static char *print_array(cJSON *item,int depth,int fmt,cJSON_Buf* buf);
-static const char *parse_object(cJSON *item,const char *value);
-static char *print_object(cJSON *item,int depth,int fmt,cJSON_Buf* buf);
-
-/* Utility to jump whitespace and cr/lf */
-static const char *skip(const char *in) {while (in && *in && (unsigned char)*in<=32) in++; return in;}
 
-/* Parse an object - create a new root, and populate. */
-cJSON *cJSON_Parse(const char *value)
+/* A node for parse_value. */
+static cJSON *parse_item(void)
 {
-	cJSON *c=cJSON_New_Item();
-	ep=0;
-	if (!c) return 0;       /* memory fail */
-
-	if (!parse_value(c,skip(value))) {cJSON_Delete(c);return 0;}
-	return c;
+	cJSON *node;
+	if (!arena_last) return cJSON_New_Item();
+	if (!(node=(cJSON*)arena_alloc(sizeof(cJSON)))) return 0;
+	memset(node,0,sizeof(cJSON));
+	node->hash_string=-1;node->allocate_type=Allocate_InBlock;
+	return node;
 }
 
-char * print_json(cJSON *item,int fmt,int padding,int estimate){
-	cJSON_Buf buf;
+/* Room for size bytes of string; *flag (the Allocate_ bit to set) is cleared when it comes from the arena. */
+static char *string_alloc(int size,int *flag)
+{
 	char *out;
-	if(estimate<256)estimate=256;
-	if(cJSON_Buf_Init(buf,estimate,padding)<0)return 0;
-	out=print_value(item,0,fmt,&buf);
-	if(!out){cJSON_Buf_Clear(buf);return 0;}
-	out=cJSON_Buf_Copy_Char(&buf,0);
-	if(!out){cJSON_Buf_Clear(buf);return 0;}
+	if (!arena_last) return (char*)cJSON_malloc(size);
+	if ((out=(char*)arena_alloc(size))) *flag=0;
 	return out;
 }
-/* Render a cJSON item/entity/structure to text. */
-char *cJSON_Print(cJSON *item,int padding,int estimate)				{return print_json(item,1,padding,estimate);}
-char *cJSON_PrintUnformatted(cJSON *item,int padding,int estimate)	{return print_json(item,0,padding,estimate);}
 
-/* Parser core - when encountering text, process appropriately. */
-static const char *parse_value(cJSON *item,const char *value)
+/* The root sits at the start of the first chunk. */
+static void arena_free(cJSON *root)
 {
-	if (!value)						return 0;	/* Fail on null. */
-	if (*value=='\"')				{ return parse_string(item,value); }
-	if (*value=='{')				{ return parse_object(item,value); }
-	if (*value=='-' || (*value>='0' && *value<='9'))	{ return parse_number(item,value); }
-	if (*value=='[')				{ return parse_array(item,value); }
-	if (!strncmp(value,"null",4))	{ item->type=cJSON_NULL;  return value+4; }
-	if (!strncmp(value,"false",5))	{ item->type=cJSON_False; return value+5; }
-	if (!strncmp(value,"true",4))	{ item->type=cJSON_True; item->valueint=1;	return value+4; }
-
-
-	ep=value;return 0;	/* failure. */
+	arena_chunk *chunk=(arena_chunk*)root-1,*next;
+	for (;chunk;chunk=next) {next=chunk->next;cJSON_free(chunk);}
 }
+#elif defined(cJSON_SLAB)
+/* Slab strings: cJSON_Parse allocates the root node with room after it for every string in the text (unescaped, none takes
+   more than its quoted text), and parse_string/parse_key carve their strings from there, unowned. */
+static __thread char *parse_slab;
 
-/* Render a value to text. */
-static char *print_value(cJSON *item,int depth,int fmt,cJSON_Buf* buf)
+static cJSON *new_root(const char *value)
+{
+	cJSON *node=(cJSON*)cJSON_malloc(sizeof(cJSON)+strlen(value)+1);
+	if (!node) return 0;
+	memset(node,0,sizeof(cJSON));
+	node->hash_string=-1;node->allocate_type=Allocate_Slab;
+	parse_slab=(char*)(node+1);
+	return node;
+}
+#define end_slab() (parse_slab=0)
+
+/* Room for size bytes of string; *flag (the Allocate_ bit to set) is cleared when it comes from the slab. */
+static char *string_alloc(int size,int *flag)
+{
+	char *out=parse_slab;
+	if (!out) return (char*)cJSON_malloc(size);
+	parse_slab+=size;*flag=0;
+	return out;
+}
+#else
+#define new_root(value) cJSON_New_Item()
+#define end_slab() ((void)0)
+#define string_alloc(size,flag) ((char*)cJSON_malloc(size))
+#endif
+#ifndef cJSON_ARENA
+#define parse_item() cJSON_New_Item()
+#endif
+
+static const char *parse_string(cJSON *item,const char *str)
+{
+	char *out;int len,flag=Allocate_Value;
+	if (*str!='\"') {ep=str;return 0;}	/* not a string! */
+	
+	len=string_length(str);	/* This is how long we need for the string, roughly. */
+	if ((unsigned)len<INLINE_SIZE && !(item->allocate_type&Allocate_Inline_Key)) {out=inline_buf(item);item->allocate_type|=Allocate_Inline_Value;}
+	else if ((out=string_alloc(len+1,&flag))) item->allocate_type|=flag;
+	else return 0;
+	
+	item->valuestring=out;
+	item->type=cJSON_String;
+	return unescape_string(str,out,0);
+}
+
+/* Key interning: an open addressed table of shared, never freed key strings, each stored after its hash. */
+typedef struct intern_key {
+	int hash;
+	char string[1];
+} intern_key;
+
+struct cJSON_InternTable {
+	intern_key **slots;
+	int size,count,max_keys;
+};
+
+static __thread cJSON_InternTable *intern_table;
+static __thread pthread_mutex_t *intern_lock;	/* set while cJSON_ParseParallel's threads share intern_table. */
+
+cJSON_InternTable *cJSON_CreateInternTable(int max_keys)
+{
+	cJSON_InternTable *table=(cJSON_InternTable*)cJSON_malloc(sizeof(cJSON_InternTable));
+	if (!table) return 0;
+	table->size=256;table->count=0;table->max_keys=(max_keys>0)?max_keys:65536;
+	if (!(table->slots=(intern_key**)cJSON_malloc(table->size*sizeof(intern_key*)))) {cJSON_free(table);return 0;}
+	memset(table->slots,0,table->size*sizeof(intern_key*));
+	return table;
+}
+
+void cJSON_DeleteInternTable(cJSON_InternTable *table)
+{
+	int i;
+	if (!table) return;
+	for (i=0;i<table->size;i++) if (table->slots[i]) cJSON_free(table->slots[i]);
+	cJSON_free(table->slots);
+	cJSON_free(table);
+}
+
+/* Find or add key (of len bytes) and return the entry, 0 when the table is full or memory fails. */
+static intern_key *intern_lookup(cJSON_InternTable *table,const char *key,int len)
+{
+	intern_key *k,**slots;int hash=BKDRHash(key),i,j;
+	for (i=hash&(table->size-1);(k=table->slots[i]);i=(i+1)&(table->size-1))
+		if (k->hash==hash && !memcmp(k->string,key,len+1)) return k;
+	if (table->count>=table->max_keys) return 0;
+	if ((table->count+1)*2>table->size)
+	{	/* keep it at most half full. */
+		if (!(slots=(intern_key**)cJSON_malloc(table->size*2*sizeof(intern_key*)))) return 0;
+		memset(slots,0,table->size*2*sizeof(intern_key*));
+		for (j=0;j<table->size;j++) if ((k=table->slots[j]))
+		{
+			for (i=k->hash&(table->size*2-1);slots[i];i=(i+1)&(table->size*2-1));
+			slots[i]=k;
+		}
+		cJSON_free(table->slots);
+		table->slots=slots;table->size*=2;
+		for (i=hash&(table->size-1);table->slots[i];i=(i+1)&(table->size-1));
+	}
+	if (!(k=(intern_key*)cJSON_malloc(sizeof(intern_key)+len))) return 0;
+	k->hash=hash;memcpy(k->string,key,len+1);
+	table->slots[i]=k;table->count++;
+	return k;
+}
+
+const char *cJSON_Intern(cJSON_InternTable *table,const char *string)
+{
+	intern_key *k=table?intern_lookup(table,string,strlen(string)):0;
+	return k?k->string:0;
+}
+
+void cJSON_SetInternTable(cJSON_InternTable *table) {intern_table=table;}
+
+static const char *skip(const char *in);
+
+/* Parse an object member's name into item->string, shared from the intern table when there is one,
+   inline when it is short and the value coming up will not need the space. */
+static const char *parse_key(cJSON *item,const char *str)
+{
+	char temp[256],*out;int len,flag=Allocate_Key;intern_key *k;const char *end,*next;
+	if (*str!='\"') {ep=str;return 0;}	/* not a string! */
+	if ((len=string_length(str))>=(int)sizeof(temp))
+	{
+		if (!(out=string_alloc(len+1,&flag))) return 0;
+		item->string=out;item->allocate_type|=flag;
+		end=unescape_string(str,out,0);
+		if (parse_stats) parse_stats->string_bytes+=end-str-2;
+		return end;
+	}
+	end=unescape_string(str,temp,&len);
+	if (parse_stats) parse_stats->string_bytes+=end-str-2;
+	if (intern_table)
+	{
+		if (intern_lock) pthread_mutex_lock(intern_lock);
+		k=intern_lookup(intern_table,temp,len);
+		if (intern_lock) pthread_mutex_unlock(intern_lock);
+		if (k) {item->string=k->string;item->hash_string=k->hash;return end;}
+	}
+	next=skip(end);
+	if (*next==':') next=skip(next+1);
+	if ((unsigned)len<INLINE_SIZE && (*next=='{' || *next=='[' || *next=='n')) {out=inline_buf(item);item->allocate_type|=Allocate_Inline_Key;}
+	else if ((out=string_alloc(len+1,&flag))) item->allocate_type|=flag;
+	else return 0;
+	memcpy(out,temp,len+1);
+	item->string=out;
+	return end;
+}
+
+/* Render the cstring provided to an escaped version that can be printed. */
+static char *print_string_ptr(const char *str,cJSON_Buf* buf)
+{
+	const char *ptr=str;unsigned char token;char*out=0;
+	char temp[6];
+	if(!cJSON_Buf_Copy_Char(buf,'\"'))return 0;
+	
+	while (*ptr)
+	{
+		if ((unsigned char)*ptr>31 && *ptr!='\"' && *ptr!='\\') out=cJSON_Buf_Copy_Char(buf,*ptr++);
+		else
+		{
+			if(!cJSON_Buf_Copy_Char(buf,'\\'))return 0;
+			switch (token=*ptr++)
+			{
+				case '\\':	out=cJSON_Buf_Copy_Char(buf,'\\');break;
+				case '\"':	out=cJSON_Buf_Copy_Char(buf,'\"');break;
+				case '\b':	out=cJSON_Buf_Copy_Char(buf,'b');break;
+				case '\f':	out=cJSON_Buf_Copy_Char(buf,'f');break;
+				case '\n':	out=cJSON_Buf_Copy_Char(buf,'n');break;
+				case '\r':	out=cJSON_Buf_Copy_Char(buf,'r');break;
+				case '\t':	out=cJSON_Buf_Copy_Char(buf,'t');break;
+				default: sprintf(temp,"u%04x",token);out=cJSON_Buf_Copy_Str(buf,temp);break;	/* escape and print */
+			}
+		}
+		if(!out)return 0;
+	}
+	if(!cJSON_Buf_Copy_Char(buf,'\"'))return 0;
+	return buf->buf;
+}
+/* Invote print_string_ptr (which is useful) on an item. */
+/* When printing for cJSON_PrintIov, point at str rather than copy it if it is long and (quote: as a string) needs no escaping.
+   Returns 1 if referenced, 0 if it has to be copied, -1 on memory fail. */
+static int print_reference(const char *str,int quote,cJSON_Buf* buf)
+{
+	iov_refs *refs=print_refs;const char *end=str;iov_ref *grown;
+	if (!refs) return 0;
+	if (quote) while (*end && (unsigned char)*end>31 && *end!='\"' && *end!='\\') end++;
+	else end+=strlen(str);
+	if (*end || end-str<refs->min_ref) return 0;
+	if (refs->count==refs->size)
+	{
+		if (!(grown=(iov_ref*)cJSON_malloc(refs->size*2*sizeof(iov_ref)))) return -1;	/* memory fail */
+		memcpy(grown,refs->refs,refs->count*sizeof(iov_ref));
+		cJSON_free(refs->refs);
+		refs->refs=grown;refs->size*=2;
+	}
+	if (quote && !cJSON_Buf_Copy_Char(buf,'\"')) return -1;
+	refs->refs[refs->count].offset=buf->offset;refs->refs[refs->count].data=str;refs->refs[refs->count].len=end-str;refs->count++;
+	if (quote && !cJSON_Buf_Copy_Char(buf,'\"')) return -1;
+	return 1;
+}
+
+static char *print_string(cJSON *item,cJSON_Buf* buf)
+{
+	int ref=print_reference(item->valuestring,1,buf);
+	if (ref) return (ref>0)?buf->buf:0;
+	return print_string_ptr(item->valuestring,buf);
+}
+
+/* Predeclare these prototypes. */
+static const char *parse_value(cJSON *item,const char *value);
+static char *print_value(cJSON *item,int depth,int fmt,cJSON_Buf* buf);
+
+/* Utility to jump whitespace and cr/lf */
+static const char *skip(const char *in) {while (in && *in && (unsigned char)*in<=32) in++; return in;}
+static const char *skip_bounded(const char *in,const char *end) {while (in && in<end && *in && (unsigned char)*in<=32) in++; return in;}
+
+/* Jump a whole value without building it. Only strings and nesting are tracked, the contents are checked when parsed. */
+static const char *skip_value(const char *in,const char *end)
+{
+	int depth=0;
+	if (!in) return 0;
+	if (in<end && *in!='{' && *in!='[' && *in!='\"')
+	{	/* scalar, runs up to the next delimiter. */
+		while (in<end && *in && *in!=',' && *in!='}' && *in!=']' && (unsigned char)*in>32) in++;
+		return in;
+	}
+	while (in<end && *in)
+	{
+		switch (*in++)
+		{
+			case '\"':
+				while (in<end && *in!='\"')
+				{
+					if (!*in) {ep=in;return 0;}
+					if (*in++=='\\' && in<end && *in) in++;
+				}
+				if (in>=end) {ep=end;return 0;}	/* unterminated string. */
+				in++;
+				break;
+			case '{': case '[': depth++;break;
+			case '}': case ']': depth--;break;
+		}
+		if (!depth) return in;
+	}
+	ep=in;return 0;	/* unbalanced. */
+}
+
+/* Jump a string the way unescape_string reads it: an unterminated one runs to the end of the text. */
+static const char *skip_string_checked(const char *in,const char *end)
+{
+	int i;
+	in++;
+	while (in<end && *in && *in!='\"')
+	{
+		if (*in++!='\\') continue;
+		if (in>=end || !*in) break;
+		if (*in=='u') {for (i=0;i<4 && in+1<end && in[1];i++) in++;}
+		in++;
+	}
+	if (in>=end) return end;
+	return (*in=='\"')?in+1:in;
+}
+
+/* Jump the text parse_number would read, stopping at end. */
+static const char *skip_number_checked(const char *num,const char *end)
+{
+	if (num<end && *num=='-') num++;
+	if (num<end && *num=='0') num++;
+	if (num<end && *num>='1' && *num<='9')	do num++; while (num<end && *num>='0' && *num<='9');
+	if (num<end && *num=='.') {num++;if (num<end) num++;while (num<end && *num>='0' && *num<='9') num++;}
+	if (num<end && (*num=='e' || *num=='E'))
+	{	num++;if (num<end && (*num=='+' || *num=='-')) num++;
+		while (num<end && *num>='0' && *num<='9') num++;
+	}
+	return num;
+}
+
+/* An object member's name and colon, returns where its value starts. */
+static const char *skip_key_checked(const char *in,const char *end)
+{
+	if (in>=end || *in!='\"') {ep=in;return 0;}	/* not a string! */
+	in=skip_bounded(skip_string_checked(in,end),end);
+	if (in>=end || *in!=':') {ep=in;return 0;}	/* fail! */
+	return skip_bounded(in+1,end);
+}
+
+/* Jump a whole value, accepting exactly what parse_value accepts and failing with ep where it fails, without building
+   anything. depth is how many containers value is already in, for the nesting limit. Nesting is a bit stack, one bit
+   per level saying whether it is an object. */
+static const char *skip_checked(const char *value,const char *end,int depth)
+{
+	unsigned int local[8],*objects=local,*grown;int bits=256,level=0,is_object;const char *open;
+	while (1)
+	{
+		/* a value is expected at value. */
+		if (value<end && *value=='\"') value=skip_string_checked(value,end);
+		else if (value<end && (*value=='-' || (*value>='0' && *value<='9'))) value=skip_number_checked(value,end);
+		else if (value<end && (*value=='{' || *value=='['))
+		{
+			open=value;is_object=(*value=='{');
+			value=skip_bounded(value+1,end);
+			if (value<end && *value==(is_object?'}':']')) value++;	/* empty array/object. */
+			else
+			{
+				if (depth+level>=nesting_limit) {ep=open;goto fail;}	/* too deep. */
+				if (level>=bits)
+				{
+					if (!(grown=(unsigned int*)cJSON_malloc(bits/4))) {ep=open;goto fail;}	/* memory fail */
+					memcpy(grown,objects,bits/8);
+					if (objects!=local) cJSON_free(objects);
+					objects=grown;bits*=2;
+				}
+				if (is_object) objects[level/32]|=1u<<(level%32); else objects[level/32]&=~(1u<<(level%32));
+				level++;
+				if (is_object && !(value=skip_key_checked(value,end))) goto fail;
+				continue;
+			}
+		}
+		else if (end-value>=4 && !strncmp(value,"null",4))	value+=4;
+		else if (end-value>=5 && !strncmp(value,"false",5))	value+=5;
+		else if (end-value>=4 && !strncmp(value,"true",4))	value+=4;
+		else {ep=value;goto fail;}	/* failure. */
+
+		/* the value is done, move on to its next sibling or close its parents. */
+		while (level)
+		{
+			is_object=(objects[(level-1)/32]>>((level-1)%32))&1;
+			value=skip_bounded(value,end);
+			if (value<end && *value==',')
+			{
+				value=skip_bounded(value+1,end);
+				if (is_object && !(value=skip_key_checked(value,end))) goto fail;
+				break;
+			}
+			if (value>=end || *value!=(is_object?'}':']')) {ep=value;goto fail;}	/* malformed. */
+			value++;level--;
+		}
+		if (!level) break;
+	}
+	if (objects!=local) cJSON_free(objects);
+	return value;
+fail:
+	if (objects!=local) cJSON_free(objects);
+	return 0;
+}
+
+/* Parse an object - create a new root, and populate. Timed by the caller. */
+static cJSON *parse_root(const char *value)
+{
+	cJSON *c;
+	trace_parse_begin();
+	c=new_root(value);
+	ep=0;
+	if (!c) {trace_parse_end(0);return 0;}       /* memory fail */
+
+	value=parse_value(c,skip(value));
+	end_slab();
+	trace_parse_end(value!=0);
+	if (!value) {delete_tree(c);return 0;}
+	return c;
+}
+
+cJSON *cJSON_Parse(const char *value)
+{
+	long long start=trace_start();
+	cJSON *c=parse_root(value);
+	trace_end(c?cJSON_Trace_Parse:cJSON_Trace_ParseError,start);
+	return c;
+}
+
+cJSON *cJSON_LoadFromFile(const char *filename)
+{
+	long len;size_t total=0,nread;char *buf;cJSON *json;
+	FILE *fp=fopen(filename,"rb");
+	if (!fp) return 0;
+	fseek(fp,0L,SEEK_END);
+	len=ftell(fp);
+	fseek(fp,0L,SEEK_SET);
+	if (len<0 || !(buf=(char*)malloc(len+1))) {fclose(fp);return 0;}
+	while (total<(size_t)len && (nread=fread(buf+total,1,len-total,fp))>0) total+=nread;
+	fclose(fp);
+	if (total<(size_t)len) {free(buf);return 0;}
+	buf[len]=0;
+	json=cJSON_Parse(buf);
+	free(buf);
+	return json;
+}
+
+/* One slice of a parallel array parse: the elements from start up to the separator at stop. It carries the caller's
+   parse state (options, intern table, whether stats are wanted) for the thread that runs it, and brings back its error. */
+typedef struct parse_chunk {
+	const char *start,*stop;
+	cJSON *first,*last;
+	int ok,count;
+	const char *error;
+	int options;
+	cJSON_InternTable *table;
+	pthread_mutex_t *lock;
+	cJSON_ParseStats stats,*want_stats;
+} parse_chunk;
+
+static void *parse_chunk_run(void *arg)
+{
+	parse_chunk *chunk=(parse_chunk*)arg;
+	const char *value=chunk->start;
+	cJSON *child;
+	int saved_options=parse_options,saved_depth=parse_depth;cJSON_ParseStats *saved_stats=parse_stats;
+	cJSON_InternTable *saved_table=intern_table;pthread_mutex_t *saved_lock=intern_lock;const char *saved_ep=ep;
+
+	parse_options=chunk->options;parse_depth=1;parse_stats=chunk->want_stats?&chunk->stats:0;
+	intern_table=chunk->table;intern_lock=chunk->lock;
+	chunk->ok=0;ep=0;
+	while (1)
+	{
+		if (!(child=cJSON_New_Item())) break;	/* memory fail */
+		if (chunk->last) suffix_object(chunk->last,child); else chunk->first=child;
+		chunk->last=child;chunk->count++;
+		value=skip(parse_value(child,skip(value)));
+		if (!value || value>chunk->stop) break;
+		if (value==chunk->stop) {chunk->ok=1;break;}
+		if (*value!=',') break;
+		value++;
+	}
+	chunk->error=ep;ep=saved_ep;
+	parse_options=saved_options;parse_depth=saved_depth;parse_stats=saved_stats;
+	intern_table=saved_table;intern_lock=saved_lock;
+	return 0;
+}
+
+/* Add a chunk's stats to the caller's. */
+static void merge_stats(cJSON_ParseStats *stats,const cJSON_ParseStats *chunk)
+{
+	stats->nodes+=chunk->nodes;stats->strings+=chunk->strings;stats->numbers+=chunk->numbers;
+	stats->string_bytes+=chunk->string_bytes;
+	if (chunk->max_depth>stats->max_depth) stats->max_depth=chunk->max_depth;
+	if (chunk->largest_array>stats->largest_array) stats->largest_array=chunk->largest_array;
+	if (chunk->largest_object>stats->largest_object) stats->largest_object=chunk->largest_object;
+}
+
+/* Below this size the thread start-up costs more than the parse. */
+#define PARALLEL_MIN_BYTES (256*1024)
+
+/* Parse a top-level array on several threads. Element boundaries are found with skip_value, each thread parses a run of
+   elements into its own chain and the chains are spliced in order. A parse error in a chunk is the serial parse's error
+   when every chunk before it parsed, so the first one is handed back; anything else falls back to cJSON_Parse. */
+cJSON *cJSON_ParseParallel(const char *value,int threads)
+{
+	parse_chunk *chunks=0;pthread_t *tids=0;pthread_mutex_t lock=PTHREAD_MUTEX_INITIALIZER;
+	const char *ptr,*end,*cut;int i,n=0,*started=0,count=0;size_t target;
+	cJSON *c=0,*last=0;long long start=trace_start();
+
+	ep=0;
+	ptr=skip(value);
+	if (!ptr || threads<=1 || *ptr!='[' || (end=ptr+strlen(ptr))-ptr<PARALLEL_MIN_BYTES) goto serial;
+
+	chunks=(parse_chunk*)cJSON_malloc(threads*sizeof(parse_chunk));
+	tids=(pthread_t*)cJSON_malloc(threads*sizeof(pthread_t));
+	started=(int*)cJSON_malloc(threads*sizeof(int));
+	if (!chunks || !tids || !started) goto serial;
+	memset(chunks,0,threads*sizeof(parse_chunk));
+	memset(started,0,threads*sizeof(int));
+
+	/* Find the depth-1 separators, cutting a chunk every target bytes. */
+	target=(end-ptr)/threads+1;
+	ptr=skip(ptr+1);
+	if (*ptr==']') goto serial;
+	chunks[0].start=cut=ptr;
+	while (1)
+	{
+		ptr=skip(skip_value(ptr,end));
+		if (!ptr) goto serial;
+		if (*ptr==']') {chunks[n++].stop=ptr;break;}
+		if (*ptr!=',') goto serial;
+		if ((size_t)(ptr-cut)>=target && n<threads-1) {chunks[n++].stop=ptr;chunks[n].start=cut=skip(ptr+1);}
+		ptr=skip(ptr+1);
+	}
+
+	for (i=0;i<n;i++)
+	{
+		chunks[i].options=parse_options;chunks[i].want_stats=parse_stats;
+		chunks[i].table=intern_table;chunks[i].lock=intern_table?&lock:0;
+	}
+	for (i=1;i<n;i++) started[i]=!pthread_create(&tids[i],0,parse_chunk_run,&chunks[i]);
+	parse_chunk_run(&chunks[0]);
+	for (i=1;i<n;i++) {if (started[i]) pthread_join(tids[i],0); else parse_chunk_run(&chunks[i]);}
+
+	for (i=0;i<n;i++) if (!chunks[i].ok)
+	{	/* a memory fail or an element ending where skip_value's did not leave no error; stats want the serial count. */
+		if (!chunks[i].error || parse_stats) goto serial;
+		ep=chunks[i].error;
+		for (i=0;i<n;i++) delete_tree(chunks[i].first);
+		cJSON_free(chunks);cJSON_free(tids);cJSON_free(started);
+		trace_end(cJSON_Trace_ParseError,start);
+		return 0;
+	}
+	if (!(c=cJSON_New_Item())) goto serial;
+	c->type=cJSON_Array;
+	for (i=0;i<n;i++)
+	{
+		if (last) suffix_object(last,chunks[i].first); else c->child=chunks[i].first;
+		last=chunks[i].last;
+	}
+	if (parse_stats)
+	{	/* the top-level array, then what the chunks counted under it. */
+		parse_stats->nodes++;
+		if (parse_stats->max_depth<1) parse_stats->max_depth=1;
+		for (i=0;i<n;i++) {merge_stats(parse_stats,&chunks[i].stats);count+=chunks[i].count;}
+		if (count>parse_stats->largest_array) parse_stats->largest_array=count;
+	}
+	cJSON_free(chunks);cJSON_free(tids);cJSON_free(started);
+	ep=0;
+	trace_end(cJSON_Trace_Parse,start);
+	return c;
+
+serial:
+	if (chunks) for (i=0;i<n;i++) delete_tree(chunks[i].first);
+	if (chunks) cJSON_free(chunks);
+	if (tids) cJSON_free(tids);
+	if (started) cJSON_free(started);
+	c=parse_root(value);
+	trace_end(c?cJSON_Trace_Parse:cJSON_Trace_ParseError,start);
+	return c;
+}
+
+/* Adaptive buffer sizing: a moving average of recent output sizes (1/8 weight to the newest) and of how far they stray
+   from it (1/4), sized to fit nearly every print without a realloc. Each step moves at least 1, so a repeated size is
+   learnt exactly, and a print under a quarter of the average starts it over. Updates are relaxed atomics, so a sizer can
+   be shared. */
+#define SIZER_SHAPES 64
+static __thread cJSON_PrintSizer thread_sizers[2][SIZER_SHAPES];	/* unformatted, formatted; by shape. */
+
+/* The thread's sizer for prints shaped like item: object or not, and the bit length of its child count. */
+static cJSON_PrintSizer *thread_sizer(cJSON *item,int fmt)
+{
+	int n=0,bits=0,type=item?item->type&255:0;cJSON *c=(type==cJSON_Array || type==cJSON_Object)?item->child:0;
+	while (c && n<(1<<24)) n++,c=c->next;
+	while (n) bits++,n>>=1;
+	return &thread_sizers[fmt!=0][(bits<<1)|(type==cJSON_Object)];
+}
+
+static int sizer_estimate(cJSON_PrintSizer *sizer)
+{
+	int average=__atomic_load_n(&sizer->average,__ATOMIC_RELAXED),deviation=__atomic_load_n(&sizer->deviation,__ATOMIC_RELAXED);
+	if (!average) return 4096;	/* nothing learnt yet. */
+	return average+2*deviation+64;
+}
+
+static int sizer_step(int diff,int weight) {return diff/weight?diff/weight:(diff>0)-(diff<0);}
+
+static void sizer_learn(cJSON_PrintSizer *sizer,int len)
+{
+	int average=__atomic_load_n(&sizer->average,__ATOMIC_RELAXED),deviation=__atomic_load_n(&sizer->deviation,__ATOMIC_RELAXED);
+	int miss=(len>average)?len-average:average-len;
+	if (!average || len<average/4) {average=len;deviation=len/16;}
+	else {average+=sizer_step(len-average,8);deviation+=sizer_step(miss-deviation,4);}
+	__atomic_store_n(&sizer->average,average>0?average:1,__ATOMIC_RELAXED);
+	__atomic_store_n(&sizer->deviation,deviation,__ATOMIC_RELAXED);
+}
+
+/* estimate<=0 sizes the buffer with sizer, or the thread's own for item's shape when that is 0 too. */
+char * print_json(cJSON *item,int fmt,int padding,int estimate,cJSON_PrintSizer *sizer){
+	cJSON_Buf buf;
+	char *out;
+	long long start=trace_start();
+	if(estimate<=0){if(!sizer)sizer=thread_sizer(item,fmt);estimate=sizer_estimate(sizer);}
+	else sizer=0;
+	if(estimate<256)estimate=256;
+	if(cJSON_Buf_Init(&buf,estimate+padding,padding)<0)return 0;
+	out=print_value(item,0,fmt,&buf);
+	if(!out){cJSON_Buf_Clear(&buf);return 0;}
+	if(sizer)sizer_learn(sizer,buf.offset-padding);
+	out=cJSON_Buf_Copy_Char(&buf,0);
+	if(!out){cJSON_Buf_Clear(&buf);return 0;}
+	count_free(out);	/* the caller's now. */
+	trace_end(cJSON_Trace_Print,start);
+	return out;
+}
+/* Render a cJSON item/entity/structure to text. */
+char *cJSON_Print(cJSON *item,int padding,int estimate)				{return print_json(item,1,padding,estimate,0);}
+char *cJSON_PrintUnformatted(cJSON *item,int padding,int estimate)	{return print_json(item,0,padding,estimate,0);}
+char *cJSON_PrintSized(cJSON *item,int fmt,cJSON_PrintSizer *sizer)	{return print_json(item,fmt,0,0,sizer);}
+
+char *cJSON_PrintBuf(cJSON *item,int fmt,cJSON_Buf *buf)
+{
+	long long start;
+	if (!buf) return print_json(item,fmt,0,0,0);
+	start=trace_start();
+	if (!print_value(item,0,fmt,buf) || !cJSON_Buf_Copy_Char(buf,0)) return 0;
+	trace_end(cJSON_Trace_Print,start);
+	return buf->buf;
+}
+
+/* Print with head bytes free before the text and at least tail after it, for framing the message in place. */
+char *cJSON_PrintFramed(cJSON *item,int fmt,int head,int tail,int *offset,int *len)
+{
+	cJSON_Buf buf;cJSON_PrintSizer *sizer=thread_sizer(item,fmt);long long start=trace_start();
+	if (head<0 || tail<0) return 0;
+	if (cJSON_Buf_Init(&buf,sizer_estimate(sizer)+head+tail,head)<0) return 0;
+	if (!print_value(item,0,fmt,&buf) || cJSON_Buf_Check(&buf,tail+1)<0) {cJSON_Buf_Clear(&buf);return 0;}
+	sizer_learn(sizer,buf.offset-head);
+	buf.buf[buf.offset]=0;
+	if (offset) *offset=head;
+	if (len) *len=buf.offset-head;
+	count_free(buf.buf);	/* the caller's now. */
+	trace_end(cJSON_Trace_Print,start);
+	return buf.buf;
+}
+
+/* The thread's retained print buffer. It is sized like print_json's and kept between prints; once it has run at more
+   than 4x what recent prints need for VIEW_IDLE prints in a row it is cut back to fit them. A thread key frees it when
+   the thread exits. */
+#define VIEW_IDLE 64
+static __thread cJSON_Buf view_buf;
+static __thread cJSON_PrintSizer view_sizer;
+static __thread int view_idle;
+static pthread_key_t view_key;
+static pthread_once_t view_once=PTHREAD_ONCE_INIT;
+static void view_exit(void *buf) {cJSON_Buf_Clear((cJSON_Buf*)buf);((cJSON_Buf*)buf)->buf=0;}
+static void view_init(void) {pthread_key_create(&view_key,view_exit);}
+
+const char *cJSON_PrintView(cJSON *item,int fmt,int *len)
+{
+	int estimate;char *ptr;
+	long long start=trace_start();
+	if (!view_buf.buf)
+	{
+		if (cJSON_Buf_Init(&view_buf,sizer_estimate(&view_sizer),0)<0) {view_buf.buf=0;return 0;}
+		pthread_once(&view_once,view_init);
+		pthread_setspecific(view_key,&view_buf);
+	}
+	view_buf.offset=0;
+	if (!print_value(item,0,fmt,&view_buf) || !cJSON_Buf_Copy_Char(&view_buf,0)) return 0;
+	sizer_learn(&view_sizer,view_buf.offset-1);
+	estimate=sizer_estimate(&view_sizer);
+	if (view_buf.len<=4*estimate) view_idle=0;
+	else if (++view_idle>=VIEW_IDLE && (ptr=(char*)cJSON_realloc(view_buf.buf,view_buf.len,estimate>view_buf.offset?estimate:view_buf.offset)))
+	{
+		view_buf.len=estimate>view_buf.offset?estimate:view_buf.offset;
+		view_buf.buf=ptr;view_idle=0;
+	}
+	if (len) *len=view_buf.offset-1;
+	trace_end(cJSON_Trace_Print,start);
+	return view_buf.buf;
+}
+
+void cJSON_ReleasePrintView(void)
+{
+	if (view_buf.buf) cJSON_Buf_Clear(&view_buf);
+	view_buf.buf=0;view_idle=0;
+}
+
+/* Containers being filled by parse_value / printed by print_value. They live on an explicit stack, so deep nesting
+   costs heap instead of C stack; the first few levels sit in a local array so shallow documents never allocate. */
+typedef struct cJSON_Frame {
+	cJSON *item;	/* the array/object. */
+	cJSON *child;	/* the item being parsed or printed in it. */
+	int depth;
+	int count;		/* parse: items parsed so far, for parse stats; print: whether a container it is in has a cache. */
+} cJSON_Frame;
+
+#define FRAME_LOCAL 32
+
+static cJSON_Frame *push_frame(cJSON_Frame **stack,int *size,int depth,cJSON_Frame *local)
+{
+	cJSON_Frame *grown;
+	if (depth>=nesting_limit) return 0;
+	if (depth<*size) return *stack+depth;
+	if (!(grown=(cJSON_Frame*)cJSON_malloc(*size*2*sizeof(cJSON_Frame)))) return 0;
+	memcpy(grown,*stack,*size*sizeof(cJSON_Frame));
+	if (*stack!=local) cJSON_free(*stack);
+	*stack=grown;*size*=2;
+	return grown+depth;
+}
+
+/* Parser core - when encountering text, process appropriately. */
+static const char *parse_value(cJSON *item,const char *value)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth=0;
+	cJSON *child;
+
+	while (1)
+	{
+		/* a value belongs at value, fill item with it. */
+		if (!value)						goto fail;	/* Fail on null. */
+		if (parse_stats) parse_stats->nodes++;
+		if (*value=='\"')
+		{
+			const char *start=value;
+			value=parse_string(item,value);
+			if (parse_stats && value) {parse_stats->strings++;parse_stats->string_bytes+=value-start-2;}
+		}
+		else if (*value=='-' || (*value>='0' && *value<='9'))
+		{
+			value=(parse_options&cJSON_Parse_RawNumbers)?parse_raw_number(item,value):parse_number(item,value);
+			if (parse_stats) parse_stats->numbers++;
+		}
+		else if (*value=='{' || *value=='[')
+		{
+			const char *open=value;
+			item->type=(*value=='{')?cJSON_Object:cJSON_Array;
+			value=skip(value+1);
+			if (*value==((item->type==cJSON_Object)?'}':']')) value++;	/* empty array/object. */
+			else
+			{
+				if (parse_depth+depth>=nesting_limit || !(top=push_frame(&stack,&size,depth,local))) {ep=open;goto fail;}	/* too deep, or memory fail */
+				depth++;
+				if (parse_stats && parse_depth+depth>parse_stats->max_depth) parse_stats->max_depth=parse_depth+depth;
+				top->item=item;top->count=1;
+				item->child=top->child=child=parse_item();
+				if (!child) goto fail;		 /* memory fail */
+				if (item->type==cJSON_Object)
+				{
+					value=skip(parse_key(child,skip(value)));
+					if (!value) goto fail;
+					if (*value!=':') {ep=value;goto fail;}	/* fail! */
+					value++;
+				}
+				item=child;value=skip(value);
+				continue;
+			}
+		}
+		else if (!strncmp(value,"null",4))	{ item->type=cJSON_NULL;  value+=4; }
+		else if (!strncmp(value,"false",5))	{ item->type=cJSON_False; value+=5; }
+		else if (!strncmp(value,"true",4))	{ item->type=cJSON_True; set_true(item);	value+=4; }
+		else { if (parse_stats) parse_stats->nodes--;ep=value;goto fail; }	/* failure, and not a value to count. */
+		if (!value) goto fail;
+
+		/* the value is done, move on to its next sibling or close its parents. */
+		while (depth)
+		{
+			top=stack+depth-1;
+			value=skip(value);
+			if (*value==',')
+			{
+				if (!(child=parse_item())) goto fail; 	/* memory fail */
+				suffix_object(top->child,child);top->child=child;top->count++;
+				value=skip(value+1);
+				if (top->item->type==cJSON_Object)
+				{
+					value=skip(parse_key(child,value));
+					if (!value) goto fail;
+					if (*value!=':') {ep=value;goto fail;}	/* fail! */
+					value=skip(value+1);
+				}
+				item=child;
+				break;
+			}
+			if (*value!=((top->item->type==cJSON_Object)?'}':']')) {ep=value;goto fail;}	/* malformed. */
+			value++;depth--;	/* end of array/object */
+			if (parse_stats)
+			{
+				int *largest=(top->item->type==cJSON_Object)?&parse_stats->largest_object:&parse_stats->largest_array;
+				if (top->count>*largest) *largest=top->count;
+			}
+		}
+		if (!depth) break;
+	}
+	if (stack!=local) cJSON_free(stack);
+	return value;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	return 0;
+}
+
+/* Render a scalar to text. */
+static char *print_scalar(cJSON *item,cJSON_Buf* buf)
 {
-	char *out=0;
-	if (!item) return 0;
 	switch ((item->type)&255)
 	{
-		case cJSON_NULL:	out=cJSON_Buf_Copy_Str(buf,"null");	break;
-		case cJSON_False:	out=cJSON_Buf_Copy_Str(buf,"false");break;
-		case cJSON_True:	out=cJSON_Buf_Copy_Str(buf,"true"); break;
-		case cJSON_Number:	out=print_number(item,buf);break;
-		case cJSON_String:	out=print_string(item,buf);break;
-		case cJSON_Array:	out=print_array(item,depth,fmt,buf);break;
-		case cJSON_Object:	out=print_object(item,depth,fmt,buf);break;
+		case cJSON_NULL:	return cJSON_Buf_Copy_Str(buf,"null");
+		case cJSON_False:	return cJSON_Buf_Copy_Str(buf,"false");
+		case cJSON_True:	return cJSON_Buf_Copy_Str(buf,"true");
+		case cJSON_Number:	return print_number(item,buf);
+		case cJSON_String:	return print_string(item,buf);
+		case cJSON_Raw:		switch (print_reference(item->valuestring,0,buf)) {case 1: return buf->buf; case -1: return 0;}
+							return cJSON_Buf_Copy_Str(buf,item->valuestring);
+	}
+	return 0;
+}
+
+/* Render a value to text. Arrays are "[a, b]", objects put each member on its own line indented by depth. */
+static char *print_value(cJSON *item,int depth,int fmt,cJSON_Buf* buf)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,level=0,j,hit;
+	char *out=0;
+
+	if (!item) return 0;
+	while (1)
+	{
+		/* open item, descending into its first child if it has one. */
+		if ((hit=cache_print(item,depth,fmt,buf))<0) goto fail;
+		else if (hit) ;	/* copied from the cache. */
+		else if (((item->type)&255)==cJSON_Array || ((item->type)&255)==cJSON_Object)
+		{
+			int is_object=((item->type)&255)==cJSON_Object;
+			if (is_object) depth++;
+			if (!cJSON_Buf_Copy_Char(buf,is_object?'{':'[')) goto fail;
+			if (is_object && fmt && !cJSON_Buf_Copy_Char(buf,'\n')) goto fail;
+			if (item->child)
+			{
+				if (!(top=push_frame(&stack,&size,level,local))) goto fail;	/* too deep, or memory fail */
+				level++;
+				top->item=item;top->child=item->child;top->depth=is_object?depth:depth+1;
+				top->count=is_cached(item) || (level>1 && top[-1].count);	/* inside a cached container. */
+				if (top->count && !(item->type&cJSON_IsReference)) link_parent(top->child,item);
+				if (is_object)
+				{
+					for (j=0;fmt&&j<depth;j++) if(!cJSON_Buf_Copy_Char(buf,'\t')) goto fail;
+					if(!print_string_ptr(top->child->string,buf)) goto fail;
+					if(!cJSON_Buf_Copy_Char(buf,':')) goto fail;
+					if(fmt&&!cJSON_Buf_Copy_Char(buf,'\t')) goto fail;
+				}
+				item=top->child;depth=top->depth;
+				continue;
+			}
+			if (!cJSON_Buf_Copy_Char(buf,is_object?'}':']')) goto fail;
+			cache_store(item,is_object?depth-1:depth,fmt,buf);
+		}
+		else if (!print_scalar(item,buf)) goto fail;
+
+		/* item is done, print the separator and its next sibling or close the parents. */
+		while (level)
+		{
+			top=stack+level-1;
+			if (((top->item->type)&255)==cJSON_Object)
+			{
+				if (top->child->next && !cJSON_Buf_Copy_Char(buf,',')) goto fail;
+				if (fmt && !cJSON_Buf_Copy_Char(buf,'\n')) goto fail;
+				if ((top->child=top->child->next))
+				{
+					for (j=0;fmt&&j<top->depth;j++) if(!cJSON_Buf_Copy_Char(buf,'\t')) goto fail;
+					if(!print_string_ptr(top->child->string,buf)) goto fail;
+					if(!cJSON_Buf_Copy_Char(buf,':')) goto fail;
+					if(fmt&&!cJSON_Buf_Copy_Char(buf,'\t')) goto fail;
+					break;
+				}
+				if (!cJSON_Buf_Copy_Char(buf,'}')) goto fail;
+			}
+			else
+			{
+				if ((top->child=top->child->next))
+				{
+					if(!cJSON_Buf_Copy_Char(buf,',')) goto fail;
+					if(fmt&&!cJSON_Buf_Copy_Char(buf,' ')) goto fail;
+					break;
+				}
+				if (!cJSON_Buf_Copy_Char(buf,']')) goto fail;
+			}
+			cache_store(top->item,top->depth-1,fmt,buf);
+			level--;
+		}
+		if (!level) break;
+		item=top->child;depth=top->depth;
+		if (top->count && !(top->item->type&cJSON_IsReference)) link_parent(item,top->item);
+	}
+	out=buf->buf;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	return out;
+}
+
+/* Print into a buffer that leaves out the referenced strings, then lay the buffer pieces and the references out in order. */
+cJSON_Iov *cJSON_PrintIov(cJSON *item,int fmt,int min_ref)
+{
+	cJSON_Buf buf;iov_refs refs;cJSON_Iov *out=0;struct iovec *v;int i,pos=0;long long start=trace_start();
+
+	refs.count=0;refs.size=16;refs.min_ref=(min_ref>0)?min_ref:256;
+	if (!(refs.refs=(iov_ref*)cJSON_malloc(refs.size*sizeof(iov_ref)))) return 0;	/* memory fail */
+	if (cJSON_Buf_Init(&buf,16*1024,0)<0) {cJSON_free(refs.refs);return 0;}
+	print_refs=&refs;
+	i=print_value(item,0,fmt,&buf)!=0;
+	print_refs=0;
+	if (!i) goto fail;
+	if (!(out=(cJSON_Iov*)cJSON_malloc(sizeof(cJSON_Iov)+(2*refs.count+1)*sizeof(struct iovec)))) goto fail;
+	out->iov=v=(struct iovec*)(out+1);out->count=0;out->len=buf.offset;
+	for (i=0;i<=refs.count;i++)
+	{
+		int stop=(i<refs.count)?refs.refs[i].offset:buf.offset;
+		if (stop>pos) {v[out->count].iov_base=buf.buf+pos;v[out->count].iov_len=stop-pos;out->count++;pos=stop;}
+		if (i==refs.count) break;
+		v[out->count].iov_base=(void*)refs.refs[i].data;v[out->count].iov_len=refs.refs[i].len;out->count++;
+		out->len+=refs.refs[i].len;
+	}
+	out->text=buf.buf;
+	cJSON_free(refs.refs);
+	trace_end(cJSON_Trace_Print,start);
+	return out;
+fail:
+	cJSON_Buf_Clear(&buf);
+	cJSON_free(refs.refs);
+	return 0;
+}
+
+void cJSON_DeleteIov(cJSON_Iov *iov)
+{
+	if (!iov) return;
+	cJSON_free(iov->text);
+	cJSON_free(iov);
+}
+
+/* Writer: prints straight from calls, the same text print_value would make from the tree. The levels buffer is a stack of
+   one byte per open container; depth is its offset. */
+#define LEVEL_OBJECT 1
+#define LEVEL_ITEMS 2	/* something has been written in it. */
+#define LEVEL_KEY 4		/* an object's key is waiting for its value. */
+
+struct cJSON_Writer {
+	cJSON_Buf buf;
+	cJSON_Buf levels;
+	int fmt,done,error;
+	cJSON_Sink sink;
+	void *ctx;
+	int chunk;
+};
+
+static cJSON_Writer *writer_new(int fmt,cJSON_Sink sink,void *ctx,int chunk)
+{
+	cJSON_Writer *w=(cJSON_Writer*)cJSON_malloc(sizeof(cJSON_Writer));
+	if (!w) return 0;
+	memset(w,0,sizeof(cJSON_Writer));
+	w->fmt=fmt;w->sink=sink;w->ctx=ctx;w->chunk=(chunk>0)?chunk:16*1024;
+	if (cJSON_Buf_Init(&w->buf,sink?w->chunk:1024,0)<0) {cJSON_free(w);return 0;}
+	if (cJSON_Buf_Init(&w->levels,FRAME_LOCAL,0)<0) {cJSON_Buf_Clear(&w->buf);cJSON_free(w);return 0;}
+	return w;
+}
+
+cJSON_Writer *cJSON_CreateWriter(int fmt) {return writer_new(fmt,0,0,0);}
+cJSON_Writer *cJSON_CreateStreamWriter(int fmt,cJSON_Sink sink,void *ctx,int chunk) {return sink?writer_new(fmt,sink,ctx,chunk):0;}
+
+/* End of every call: hand full chunks to the sink. */
+static int writer_end(cJSON_Writer *w,int ok)
+{
+	if (!ok) w->error=1;
+	if (!w->error && w->sink && w->buf.offset>=w->chunk)
+	{
+		if (w->sink(w->ctx,w->buf.buf,w->buf.offset)<0) w->error=1;
+		w->buf.offset=0;
+	}
+	return w->error?-1:0;
+}
+
+/* Start of every value: check it is allowed here and write the separator before it. */
+static int writer_value(cJSON_Writer *w)
+{
+	unsigned char *top;
+	if (w->error) return 0;
+	if (!w->levels.offset) {if (w->done) return 0;w->done=1;return 1;}	/* one root value. */
+	top=(unsigned char*)w->levels.buf+w->levels.offset-1;
+	if (*top&LEVEL_OBJECT)
+	{
+		if (!(*top&LEVEL_KEY)) return 0;	/* no key. */
+		*top&=~LEVEL_KEY;
+		return 1;
+	}
+	if ((*top&LEVEL_ITEMS) && (!cJSON_Buf_Copy_Char(&w->buf,',') || (w->fmt && !cJSON_Buf_Copy_Char(&w->buf,' ')))) return 0;
+	*top|=LEVEL_ITEMS;
+	return 1;
+}
+
+static int writer_begin(cJSON_Writer *w,int is_object)
+{
+	int ok=writer_value(w) && w->levels.offset<nesting_limit && cJSON_Buf_Copy_Char(&w->levels,is_object?LEVEL_OBJECT:0)
+		&& cJSON_Buf_Copy_Char(&w->buf,is_object?'{':'[') && (!is_object || !w->fmt || cJSON_Buf_Copy_Char(&w->buf,'\n'));
+	return writer_end(w,ok);
+}
+
+static int writer_close(cJSON_Writer *w,int is_object)
+{
+	unsigned char top;int ok;
+	if (w->error || !w->levels.offset) return writer_end(w,0);
+	top=(unsigned char)w->levels.buf[w->levels.offset-1];
+	ok=((top&LEVEL_OBJECT)!=0)==is_object && !(top&LEVEL_KEY)
+		&& (!is_object || !(top&LEVEL_ITEMS) || !w->fmt || cJSON_Buf_Copy_Char(&w->buf,'\n')) && cJSON_Buf_Copy_Char(&w->buf,is_object?'}':']');
+	if (ok) w->levels.offset--;
+	return writer_end(w,ok);
+}
+
+int cJSON_Writer_BeginObject(cJSON_Writer *w)	{return writer_begin(w,1);}
+int cJSON_Writer_EndObject(cJSON_Writer *w)		{return writer_close(w,1);}
+int cJSON_Writer_BeginArray(cJSON_Writer *w)	{return writer_begin(w,0);}
+int cJSON_Writer_EndArray(cJSON_Writer *w)		{return writer_close(w,0);}
+
+int cJSON_Writer_Key(cJSON_Writer *w,const char *key)
+{
+	unsigned char *top;int j,ok;
+	if (w->error || !w->levels.offset) return writer_end(w,0);
+	top=(unsigned char*)w->levels.buf+w->levels.offset-1;
+	if (!(*top&LEVEL_OBJECT) || (*top&LEVEL_KEY)) return writer_end(w,0);
+	ok=!(*top&LEVEL_ITEMS) || (cJSON_Buf_Copy_Char(&w->buf,',') && (!w->fmt || cJSON_Buf_Copy_Char(&w->buf,'\n')));
+	for (j=0;ok && w->fmt && j<w->levels.offset;j++) ok=cJSON_Buf_Copy_Char(&w->buf,'\t')!=0;
+	ok=ok && print_string_ptr(key,&w->buf) && cJSON_Buf_Copy_Char(&w->buf,':') && (!w->fmt || cJSON_Buf_Copy_Char(&w->buf,'\t'));
+	*top|=LEVEL_ITEMS|LEVEL_KEY;
+	return writer_end(w,ok);
+}
+
+int cJSON_Writer_String(cJSON_Writer *w,const char *string)	{return writer_end(w,writer_value(w) && print_string_ptr(string,&w->buf));}
+int cJSON_Writer_Int(cJSON_Writer *w,int num)				{return writer_end(w,writer_value(w) && print_double(num,&w->buf));}
+int cJSON_Writer_Double(cJSON_Writer *w,double num)			{return writer_end(w,writer_value(w) && print_double(num,&w->buf));}
+int cJSON_Writer_Bool(cJSON_Writer *w,int b)				{return writer_end(w,writer_value(w) && cJSON_Buf_Copy_Str(&w->buf,b?"true":"false"));}
+int cJSON_Writer_Null(cJSON_Writer *w)						{return writer_end(w,writer_value(w) && cJSON_Buf_Copy_Str(&w->buf,"null"));}
+int cJSON_Writer_Raw(cJSON_Writer *w,const char *text)		{return writer_end(w,writer_value(w) && cJSON_Buf_Copy_Str(&w->buf,text));}
+int cJSON_Writer_Item(cJSON_Writer *w,cJSON *item)			{return writer_end(w,writer_value(w) && print_value(item,w->levels.offset,w->fmt,&w->buf));}
+
+int cJSON_FinishWriter(cJSON_Writer *w,char **out)
+{
+	int ok=!w->error && w->done && !w->levels.offset;
+	if (out) *out=0;
+	if (ok && w->sink) ok=!w->buf.offset || w->sink(w->ctx,w->buf.buf,w->buf.offset)>=0;
+	else if (ok && out) {ok=cJSON_Buf_Copy_Char(&w->buf,0)!=0;if (ok) {*out=w->buf.buf;w->buf.buf=0;count_free(*out);}}
+	cJSON_Buf_Clear(&w->buf);cJSON_Buf_Clear(&w->levels);
+	cJSON_free(w);
+	return ok?0:-1;
+}
+
+/* Get Array size/item / object item. What they return can be changed, so a shared handle is unshared first. */
+int    cJSON_GetArraySize(cJSON *array)							{cJSON *c=array->child;int i=0;while(c)i++,c=c->next;return i;}
+cJSON *cJSON_GetArrayItem(cJSON *array,int item)				{cJSON *c;if ((array->type&cJSON_IsShared) && cJSON_Unshare(array)) return 0;c=array->child;  while (c && item>0) item--,c=c->next; return c;}
+cJSON *cJSON_GetObjectItemV2(cJSON *object,const char *string,int*pos){
+	int hash_code=BKDRHash(string),i=0;
+	cJSON *c;
+	if ((object->type&cJSON_IsShared) && cJSON_Unshare(object)) return 0;	/* memory fail */
+	c=object->child;
+	while (c){
+		if(c->string==string){if(pos)*pos=i;return c;}	/* interned keys match on the pointer. */
+		if(c->hash_string==-1){c->hash_string=BKDRHash(c->string);}
+		if(c->hash_string==hash_code && !cJSON_strcasecmp(c->string,string)){if(pos)*pos=i;return c;}
+		c=c->next;
+		i++;
+	}
+	return c;
+}
+cJSON *cJSON_GetObjectItem(cJSON *object,const char *string){return cJSON_GetObjectItemV2(object,string,0);}
+
+/* Utility for handling references. */
+static cJSON *create_reference(cJSON *item) {cJSON *ref;if (item->type&cJSON_IsShared) return cJSON_Share(item);ref=cJSON_New_Item();if (!ref) return 0;memcpy(ref,item,sizeof(cJSON));ref->string=0;ref->allocate_type&=Allocate_Inline_Value|Allocate_Raw_Number;if (ref->allocate_type&Allocate_Inline_Value) ref->valuestring=inline_buf(ref);ref->type|=cJSON_IsReference;ref->next=0;set_prev(ref,0);clear_cache(ref);return ref;}
+
+/* Add item to array/object. */
+void   cJSON_AddItemToArray(cJSON *array, cJSON *item)						{cJSON *c;if (!item) return; if (cJSON_Unshare(array)) {cJSON_Delete(item);return;} cJSON_InvalidatePrintCache(array);set_parent(item,array);c=array->child; if (!c) {array->child=item;} else {while (c && c->next) c=c->next; suffix_object(c,item);}}
+void   cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item)	{if (!item) return; set_key(item,string);cJSON_AddItemToArray(object,item);}
+/* Strings taken over were allocated by the caller; count them in now, as they are counted out when freed. */
+void   cJSON_AddItemToObjectTake(cJSON *object,char *string,cJSON *item)	{if (string) count_alloc(string);if (!item) {cJSON_free(string);return;} adopt_key(item,string,1);cJSON_AddItemToArray(object,item);}
+void   cJSON_AddItemToObjectConst(cJSON *object,const char *string,cJSON *item)	{if (!item) return; adopt_key(item,(char*)string,0);cJSON_AddItemToArray(object,item);}
+void	cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)						{cJSON_AddItemToArray(array,create_reference(item));}
+void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item)	{cJSON_AddItemToObject(object,string,create_reference(item));}
+
+cJSON *cJSON_DetachItemFromArray(cJSON *array,int which)			{cJSON *c=array->child;while (c && which>0) c=c->next,which--; if (c) return cJSON_DetachItemFromParent(array,c);return 0;}
+void   cJSON_DeleteItemFromArray(cJSON *array,int which)			{cJSON_Delete(cJSON_DetachItemFromArray(array,which));}
+cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string) {cJSON *c=cJSON_GetObjectItemV2(object,string,0);if (c) return cJSON_DetachItemFromParent(object,c);return 0;}
+void   cJSON_DeleteItemFromObject(cJSON *object,const char *string) {cJSON_Delete(cJSON_DetachItemFromObject(object,string));}
+cJSON *cJSON_DetachItemFromParent(cJSON *object,cJSON *c)           {cJSON *prev;int i=0;if (object->type&cJSON_IsShared) {for (prev=object->child;prev && prev!=c;prev=prev->next) i++;if (!prev || cJSON_Unshare(object)) return 0;c=cJSON_GetArrayItem(object,i);}
+	cJSON_InvalidatePrintCache(object);set_parent(c,0);
+	prev=prev_item(object,c);if (prev) prev->next=c->next;if (c->next) set_prev(c->next,prev);if (c==object->child) object->child=c->next;c->next=0;set_prev(c,0);return c;}
+void   cJSON_DeleteItemFromParent(cJSON *object,cJSON *c)			{cJSON_Delete(cJSON_DetachItemFromParent(object,c));}
+
+/* Replace array/object items with new ones. */
+void   cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem)		{cJSON *c,*prev;if (cJSON_Unshare(array)) {cJSON_Delete(newitem);return;} c=array->child;while (c && which>0) c=c->next,which--;if (!c) return;
+	cJSON_InvalidatePrintCache(array);set_parent(newitem,array);
+	prev=prev_item(array,c);newitem->next=c->next;set_prev(newitem,prev);if (newitem->next) set_prev(newitem->next,newitem);
+	if (c==array->child) array->child=newitem; else prev->next=newitem;c->next=0;set_prev(c,0);cJSON_Delete(c);}
+void   cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem){int i=0;cJSON *c=cJSON_GetObjectItemV2(object,string,&i);if(c){set_key(newitem,string);cJSON_ReplaceItemInArray(object,i,newitem);}}
+
+/* Create basic types: */
+cJSON *cJSON_CreateNull()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_NULL;return item;}
+cJSON *cJSON_CreateTrue()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_True;return item;}
+cJSON *cJSON_CreateFalse()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_False;return item;}
+cJSON *cJSON_CreateBool(int b)					{cJSON *item=cJSON_New_Item();if(item)item->type=b?cJSON_True:cJSON_False;return item;}
+cJSON *cJSON_CreateNumber(double num)			{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_Number;set_number(item,num);}return item;}
+cJSON *cJSON_CreateString(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;set_valuestring(item,string,strlen(string));}return item;}
+cJSON *cJSON_CreateStringTake(char *string)		{cJSON *item;if (string) count_alloc(string);item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=string;item->allocate_type=Allocate_Value;}else cJSON_free(string);return item;}
+cJSON *cJSON_CreateStringConst(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=(char*)string;}return item;}
+cJSON *cJSON_CreateRaw(const char *text,int len,int validate)
+{
+	cJSON *item;
+	if (len<0) len=strlen(text);
+	if (validate && cJSON_Validate(text,len,0)>=0) return 0;
+	if (!(item=cJSON_New_Item())) return 0;	/* memory fail */
+	item->type=cJSON_Raw;
+	if (set_valuestring(item,text,len)) {cJSON_Delete(item);return 0;}
+	return item;
+}
+cJSON *cJSON_CreateArray()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Array;return item;}
+cJSON *cJSON_CreateObject()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Object;return item;}
+
+/* Create Arrays: */
+cJSON *cJSON_CreateIntArray(int *numbers,int count)				{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+cJSON *cJSON_CreateFloatArray(float *numbers,int count)			{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+cJSON *cJSON_CreateDoubleArray(double *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+cJSON *cJSON_CreateStringArray(const char **strings,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateString(strings[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+
+/* Duplication: a measuring walk, then the copy is laid out in one block, the nodes in walk order followed by their strings.
+   The root owns the block; the other nodes are marked Allocate_InBlock and freed with it, so they must not outlive the root. */
+static size_t dup_bytes(cJSON *c)
+{
+	size_t bytes=0;
+	if (((c->type&255)==cJSON_String || (c->type&255)==cJSON_Raw) && c->valuestring && !(c->allocate_type&Allocate_Inline_Value)) bytes+=strlen(c->valuestring)+1;
+	if (c->allocate_type&Allocate_Raw_Number) bytes+=skip_number(c->valuestring)-c->valuestring+1;
+	if (c->string && !(c->allocate_type&Allocate_Inline_Key)) bytes+=strlen(c->string)+1;
+	return bytes;
+}
+
+/* Copy len bytes of str and a NUL to the block's string area, or to the heap when there is no block. */
+static char *dup_text(char **strings,const char *str,size_t len)
+{
+	char *out=strings?*strings:(char*)cJSON_malloc(len+1);
+	if (!out) return 0;	/* memory fail */
+	memcpy(out,str,len);out[len]=0;
+	if (strings) *strings+=len+1;
+	return out;
+}
+#define dup_string(strings,str) dup_text(strings,str,strlen(str))
+
+/* Copy c into copy, unlinked and owning its strings. Returns 0, or -1 on memory fail (copy is then safe to delete). */
+static int dup_node(cJSON *copy,cJSON *c,char **strings)
+{
+	memcpy(copy,c,sizeof(cJSON));
+	copy->next=0;set_prev(copy,0);clear_cache(copy);
+	copy->type&=~(cJSON_IsReference|cJSON_IsShared);
+	copy->allocate_type=(c->allocate_type&(Allocate_Inline_Key|Allocate_Inline_Value|Allocate_Raw_Number))|(strings?Allocate_InBlock:0);
+	if ((copy->type&255)==cJSON_Array || (copy->type&255)==cJSON_Object) {copy->valuestring=0;copy->child=0;}
+	else if (((copy->type&255)==cJSON_String || (copy->type&255)==cJSON_Raw) && c->valuestring)
+	{
+		if (c->allocate_type&Allocate_Inline_Value) copy->valuestring=inline_buf(copy);
+		else if (!(copy->valuestring=dup_string(strings,c->valuestring))) return -1;
+		else if (!strings) copy->allocate_type|=Allocate_Value;
+	}
+	else if (c->allocate_type&Allocate_Raw_Number)
+	{	/* the copy keeps the digits itself rather than pointing into the parsed text. */
+		if (!(copy->valuestring=dup_text(strings,c->valuestring,skip_number(c->valuestring)-c->valuestring))) return -1;
+		if (!strings) copy->allocate_type|=Allocate_Value;
+	}
+	if (c->string)
+	{
+		if (c->allocate_type&Allocate_Inline_Key) copy->string=inline_buf(copy);
+		else if (!(copy->string=dup_string(strings,c->string))) return -1;
+		else if (!strings) copy->allocate_type|=Allocate_Key;
+	}
+	return 0;
+}
+
+/* Copy item in one block, or node by node on the heap. Frames hold the source container and the copy its next child is linked to:
+   the copied container itself (depth 1) until the first child arrives, then the last child. */
+static cJSON *dup_tree(cJSON *item,int recurse,int block)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth,pass,count=0;
+	size_t bytes=0;cJSON *c,*copy=0,*root=0;char *strings=0,**area=0;int i=0;
+
+	if (!item) return 0;
+	for (pass=block?0:1;pass<2;pass++)
+	{
+		if (pass && block)
+		{
+			if (!(root=(cJSON*)cJSON_malloc(count*sizeof(cJSON)+bytes))) goto fail;	/* memory fail */
+			strings=(char*)(root+count);area=&strings;
+		}
+		c=item;depth=0;
+		while (1)
+		{
+			if (!pass) {count++;bytes+=dup_bytes(c);}
+			else
+			{
+				if (block) dup_node(copy=root+i++,c,area);
+				else if (!(copy=cJSON_New_Item()) || dup_node(copy,c,0)) {if (!root) root=copy; else cJSON_Delete(copy);goto fail;}
+				if (!root) root=copy;
+				if (depth)
+				{
+					top=stack+depth-1;
+					if (top->depth) top->child->child=copy; else suffix_object(top->child,copy);
+					top->child=copy;top->depth=0;
+				}
+			}
+			if (recurse && ((c->type&255)==cJSON_Array || (c->type&255)==cJSON_Object) && c->child)
+			{
+				if (!(top=push_frame(&stack,&size,depth,local))) goto fail;
+				top->item=c;top->child=copy;top->depth=1;depth++;
+				c=c->child;
+				continue;
+			}
+			while (depth && !c->next) c=stack[--depth].item;
+			if (!depth) break;
+			c=c->next;
+		}
+	}
+	if (block) root->allocate_type=(root->allocate_type&~Allocate_InBlock)|Allocate_Block;
+	if (stack!=local) cJSON_free(stack);
+	return root;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	if (block) cJSON_free(root); else cJSON_Delete(root);
+	return 0;
+}
+
+cJSON *cJSON_Duplicate(cJSON *item,int recurse) {return dup_tree(item,recurse,1);}
+
+/* Shared subtrees: handles are references that also hold a count on the tree, kept with it where valuestring would be.
+   The compact layout has nowhere to keep it, so there every handle is a copy of its own. */
+#ifndef cJSON_COMPACT
+typedef struct shared_tree {
+	int refs;
+	cJSON *tree;
+} shared_tree;
+
+static cJSON *shared_handle(shared_tree *shared)
+{
+	cJSON *handle=cJSON_New_Item();
+	if (!handle) return 0;
+	memcpy(handle,shared->tree,sizeof(cJSON));
+	handle->next=0;set_prev(handle,0);clear_cache(handle);handle->string=0;handle->hash_string=-1;handle->allocate_type=Allocate_None;
+	handle->type|=cJSON_IsReference|cJSON_IsShared;
+	handle->valuestring=(char*)shared;
+	return handle;
+}
+
+/* Drop a handle's count; the last one takes the tree with it. */
+static void shared_release(cJSON *handle)
+{
+	shared_tree *shared=(shared_tree*)handle->valuestring;
+	if (__sync_sub_and_fetch(&shared->refs,1)) return;
+	delete_tree(shared->tree);
+	cJSON_free(shared);
+}
+
+/* Fill in every key's hash up front, so lookups through handles only read the tree. */
+static void shared_hash(cJSON *tree)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth=0;cJSON *c=tree;
+	while (1)
+	{
+		if (c->string && c->hash_string==-1) c->hash_string=BKDRHash(c->string);
+		if (!(c->type&cJSON_IsReference) && ((c->type&255)==cJSON_Array || (c->type&255)==cJSON_Object) && c->child && (top=push_frame(&stack,&size,depth,local)))
+		{
+			top->item=c;depth++;
+			c=c->child;
+			continue;
+		}
+		while (depth && !c->next) c=stack[--depth].item;
+		if (!depth) break;
+		c=c->next;
+	}
+	if (stack!=local) cJSON_free(stack);
+}
+
+cJSON *cJSON_CreateShared(cJSON *tree)
+{
+	shared_tree *shared;cJSON *handle;
+	if (!tree || ((tree->type&255)!=cJSON_Array && (tree->type&255)!=cJSON_Object) || (tree->type&cJSON_IsReference)) return tree;
+	if (!(shared=(shared_tree*)cJSON_malloc(sizeof(shared_tree)))) return 0;	/* memory fail */
+	if (tree->allocate_type&Allocate_Key) cJSON_free(tree->string);
+	tree->string=0;tree->allocate_type&=~(Allocate_Key|Allocate_Inline_Key);
+	shared->refs=1;shared->tree=tree;
+	shared_hash(tree);
+	if (!(handle=shared_handle(shared))) {cJSON_free(shared);return 0;}
+	return handle;
+}
+
+cJSON *cJSON_Share(cJSON *handle)
+{
+	shared_tree *shared;cJSON *copy;
+	if (!handle || !(handle->type&cJSON_IsShared)) return cJSON_Duplicate(handle,1);
+	shared=(shared_tree*)handle->valuestring;
+	__sync_add_and_fetch(&shared->refs,1);
+	if (!(copy=shared_handle(shared))) shared_release(handle);
+	return copy;
+}
+
+/* Turn the handle into an ordinary container with children of its own: the tree's, if this was the last handle, else copies.
+   Children of a Duplicate block, a slab parse or an arena parse live in their root's allocation, so those are always copied. */
+int cJSON_Unshare(cJSON *handle)
+{
+	shared_tree *shared;cJSON *copy;
+	if (!handle || !(handle->type&cJSON_IsShared)) return 0;
+	shared=(shared_tree*)handle->valuestring;
+	if (__sync_add_and_fetch(&shared->refs,0)==1 && !(shared->tree->allocate_type&(Allocate_Block|Allocate_Slab|Allocate_Arena)))
+	{
+		handle->child=shared->tree->child;
+		shared->tree->child=0;
 	}
-	return out;
+	else
+	{
+		if (!(copy=dup_tree(shared->tree,1,0))) return -1;	/* memory fail */
+		handle->child=copy->child;
+		copy->child=0;cJSON_Delete(copy);
+	}
+	shared_release(handle);
+	handle->type&=~(cJSON_IsReference|cJSON_IsShared);
+	handle->valuestring=0;
+	return 0;
 }
+#else
+static void shared_release(cJSON *handle) {}
+cJSON *cJSON_CreateShared(cJSON *tree) {return tree;}
+cJSON *cJSON_Share(cJSON *handle) {return cJSON_Duplicate(handle,1);}
+int cJSON_Unshare(cJSON *handle) {return 0;}
+#endif
 
-/* Build an array from input text. */
-static const char *parse_array(cJSON *item,const char *value)
+/* On-demand navigation: cursors walk the raw text with skip_value and only build nodes for what is asked for. */
+/* Compare the raw key between quotes against string, case insensitive like cJSON_GetObjectItem. */
+static int cursor_key_match(const char *key,const char *keyend,const char *string)
 {
-	cJSON *child;
-	if (*value!='[')	{ep=value;return 0;}	/* not an array! */
+	cJSON temp;int match;
+	if (!memchr(key,'\\',keyend-key))
+	{
+		while (key<keyend && *string && tolower(*key)==tolower(*string)) key++,string++;
+		return key==keyend && !*string;
+	}
+	memset(&temp,0,sizeof(temp));	/* escaped key, take the slow road. */
+	if (!parse_string(&temp,key-1)) return 0;
+	match=!cJSON_strcasecmp(temp.valuestring,string);
+	if (temp.allocate_type&Allocate_Value) cJSON_free(temp.valuestring);
+	return match;
+}
 
-	item->type=cJSON_Array;
-	value=skip(value+1);
-	if (*value==']') return value+1;	/* empty array. */
+int cJSON_Cursor_Init(cJSON_Cursor *cur,const char *value,int len)
+{
+	ep=0;
+	if (!cur || !value) return -1;
+	cur->end=value+(len<0?strlen(value):len);
+	cur->value=skip_bounded(value,cur->end);
+	if (cur->value>=cur->end) {ep=cur->value;return -1;}
+	return 0;
+}
 
-	item->child=child=cJSON_New_Item();
-	if (!item->child) return 0;		 /* memory fail */
-	value=skip(parse_value(child,skip(value)));	/* skip any spacing, get the value. */
-	if (!value) return 0;
+int cJSON_Cursor_Type(const cJSON_Cursor *cur)
+{
+	const char *v=cur->value;
+	if (v>=cur->end) return -1;
+	switch (*v)
+	{
+		case '{':	return cJSON_Object;
+		case '[':	return cJSON_Array;
+		case '\"':	return cJSON_String;
+		case 't':	return cJSON_True;
+		case 'f':	return cJSON_False;
+		case 'n':	return cJSON_NULL;
+	}
+	if (*v=='-' || (*v>='0' && *v<='9')) return cJSON_Number;
+	return -1;
+}
 
-	while (*value==',')
+int cJSON_Cursor_Get(const cJSON_Cursor *cur,const char *string,cJSON_Cursor *out)
+{
+	const char *ptr=cur->value,*end=cur->end,*key;int found;
+	if (ptr>=end || *ptr!='{') {ep=ptr;return -1;}	/* not an object! */
+	ptr=skip_bounded(ptr+1,end);
+	if (ptr<end && *ptr=='}') return -1;	/* empty object. */
+	while (ptr<end)
 	{
-		cJSON *new_item;
-		if (!(new_item=cJSON_New_Item())) return 0; 	/* memory fail */
-		child->next=new_item;new_item->prev=child;child=new_item;
-		value=skip(parse_value(child,skip(value+1)));
-		if (!value) return 0;	/* memory fail */
+		if (*ptr!='\"') {ep=ptr;return -1;}
+		key=ptr+1;
+		if (!(ptr=skip_value(ptr,end))) return -1;
+		found=cursor_key_match(key,ptr-1,string);
+		ptr=skip_bounded(ptr,end);
+		if (ptr>=end || *ptr!=':') {ep=ptr;return -1;}
+		ptr=skip_bounded(ptr+1,end);
+		if (found) {out->value=ptr;out->end=end;return 0;}
+		ptr=skip_bounded(skip_value(ptr,end),end);
+		if (!ptr || ptr>=end) break;
+		if (*ptr=='}') return -1;	/* not there. */
+		if (*ptr!=',') {ep=ptr;return -1;}
+		ptr=skip_bounded(ptr+1,end);
 	}
+	if (ptr) ep=ptr;
+	return -1;
+}
 
-	if (*value==']') return value+1;	/* end of array */
-	ep=value;return 0;	/* malformed. */
+int cJSON_Cursor_Index(const cJSON_Cursor *cur,int item,cJSON_Cursor *out)
+{
+	const char *ptr=cur->value,*end=cur->end;
+	if (ptr>=end || *ptr!='[') {ep=ptr;return -1;}	/* not an array! */
+	ptr=skip_bounded(ptr+1,end);
+	if (item<0 || (ptr<end && *ptr==']')) return -1;
+	while (ptr<end)
+	{
+		if (!item--) {out->value=ptr;out->end=end;return 0;}
+		ptr=skip_bounded(skip_value(ptr,end),end);
+		if (!ptr || ptr>=end) break;
+		if (*ptr==']') return -1;	/* past the end. */
+		if (*ptr!=',') {ep=ptr;return -1;}
+		ptr=skip_bounded(ptr+1,end);
+	}
+	if (ptr) ep=ptr;
+	return -1;
 }
 
-/* Render an array to text */
-static char *print_array(cJSON *item,int depth,int fmt,cJSON_Buf* buf)
+int cJSON_Cursor_Size(const cJSON_Cursor *cur)
 {
-	cJSON *child=item->child;
-	if(!cJSON_Buf_Copy_Char(buf,'['))return 0;
-	while (child)
+	const char *ptr=cur->value,*end=cur->end;int i=0;
+	if (ptr>=end || (*ptr!='[' && *ptr!='{')) {ep=ptr;return -1;}
+	ptr=skip_bounded(ptr+1,end);
+	if (ptr<end && (*ptr==']' || *ptr=='}')) return 0;
+	while (ptr<end)
 	{
-		if(!print_value(child,depth+1,fmt,buf))return 0;
-		if(child->next){if(!cJSON_Buf_Copy_Char(buf,','))return 0;if(fmt&&!cJSON_Buf_Copy_Char(buf,' '))return 0;}
-		child=child->next;
+		if (*cur->value=='{')
+		{	/* step over the key. */
+			ptr=skip_bounded(skip_value(ptr,end),end);
+			if (!ptr || ptr>=end || *ptr!=':') break;
+			ptr=skip_bounded(ptr+1,end);
+		}
+		ptr=skip_bounded(skip_value(ptr,end),end);
+		i++;
+		if (!ptr || ptr>=end) break;
+		if (*ptr==']' || *ptr=='}') return i;
+		if (*ptr!=',') break;
+		ptr=skip_bounded(ptr+1,end);
 	}
-	if(!cJSON_Buf_Copy_Char(buf,']'))return 0;
-	return buf->buf;	
+	if (ptr) ep=ptr;
+	return -1;
 }
 
-/* Build an object from the text. */
-static const char *parse_object(cJSON *item,const char *value)
+/* Build the value at value, which must be complete before end. Returns the end of it, or 0 with ep set. */
+static const char *parse_bounded(cJSON *item,const char *value,const char *end)
 {
-	cJSON *child;
-	if (*value!='{')	{ep=value;return 0;}	/* not an object! */
-	
-	item->type=cJSON_Object;
-	value=skip(value+1);
-	if (*value=='}') return value+1;	/* empty array. */
-	
-	item->child=child=cJSON_New_Item();
-	if (!item->child) return 0;
-	value=skip(parse_string(child,skip(value)));
-	if (!value) return 0;
-	child->string=child->valuestring;child->valuestring=0;
-	if (*value!=':') {ep=value;return 0;}	/* fail! */
-	value=skip(parse_value(child,skip(value+1)));	/* skip any spacing, get the value. */
-	if (!value) return 0;
-	
-	while (*value==',')
-	{
-		cJSON *new_item;
-		if (!(new_item=cJSON_New_Item()))	return 0; /* memory fail */
-		child->next=new_item;new_item->prev=child;child=new_item;
-		value=skip(parse_string(child,skip(value+1)));
-		if (!value) return 0;
-		child->string=child->valuestring;child->valuestring=0;
-		if (*value!=':') {ep=value;return 0;}	/* fail! */
-		value=skip(parse_value(child,skip(value+1)));	/* skip any spacing, get the value. */
-		if (!value) return 0;
+	const char *stop;char temp[64];
+	if (!(stop=skip_checked(value,end,parse_depth))) return 0;
+	if (stop==end && *value!='{' && *value!='[' && *value!='\"')
+	{	/* a bare scalar running to the end of unterminated text, parse a terminated copy. */
+		if (stop-value>=(int)sizeof(temp)) {ep=value;return 0;}
+		memcpy(temp,value,stop-value);temp[stop-value]=0;
+		if (parse_value(item,temp)!=temp+(stop-value)) {ep=value;return 0;}
+		return stop;
 	}
-	
-	if (*value=='}') return value+1;	/* end of array */
-	ep=value;return 0;	/* malformed. */
+	if (!(value=parse_value(item,value))) return 0;
+	if (value!=stop) {ep=value;return 0;}	/* junk after a scalar. */
+	return stop;
+}
+
+cJSON *cJSON_Cursor_Parse(const cJSON_Cursor *cur)
+{
+	cJSON *c=cJSON_New_Item();
+	ep=0;
+	if (!c) return 0;
+	if (!parse_bounded(c,cur->value,cur->end)) {cJSON_Delete(c);return 0;}
+	return c;
 }
 
-/* Render an object to text. */
-static char *print_object(cJSON *item,int depth,int fmt,cJSON_Buf* buf)
+/* Projected parse: a projection is a trie of path steps compiled once, the parser builds only the subtrees it names. */
+struct cJSON_Projection {
+	struct cJSON_Projection *next,*child;	/* sibling steps / steps below this one. */
+	char *name;								/* member name, 0 for an array step. */
+	int index;								/* element index for an array step, -1 for [*]. */
+	int whole;								/* a path ends here, keep everything below. */
+};
+
+static cJSON_Projection *projection_step(cJSON_Projection *parent,const char *name,int len,int index)
 {
-	int j=0;
-	cJSON *child=item->child;
-	depth++;
-	if(!cJSON_Buf_Copy_Char(buf,'{'))return 0;
-	if(fmt&&!cJSON_Buf_Copy_Char(buf,'\n'))return 0;
-	while (child)
+	cJSON_Projection *p,**tail;int i;
+	for (p=parent->child;p;p=p->next)
+	{	/* names match case insensitively, as keys do. */
+		if (name && p->name) {for (i=0;i<len && tolower(name[i])==tolower(p->name[i]);i++);if (i==len && !p->name[len]) return p;}
+		if (!name && !p->name && p->index==index) return p;
+	}
+	if (!(p=(cJSON_Projection*)cJSON_malloc(sizeof(cJSON_Projection)))) return 0;
+	memset(p,0,sizeof(cJSON_Projection));
+	p->index=index;
+	if (name)
 	{
-		for (j=0;fmt&&j<depth;j++) if(!cJSON_Buf_Copy_Char(buf,'\t'))return 0;
-		if(!print_string_ptr(child->string,buf))return 0;
-		if(!cJSON_Buf_Copy_Char(buf,':'))return 0;
-		if(fmt&&!cJSON_Buf_Copy_Char(buf,'\t'))return 0;
-		if(!print_value(child,depth,fmt,buf))return 0;
-		if (child->next && !cJSON_Buf_Copy_Char(buf,','))return 0;
-		if(fmt&&!cJSON_Buf_Copy_Char(buf,'\n'))return 0;
-		
-		child=child->next;
+		if (!(p->name=(char*)cJSON_malloc(len+1))) {cJSON_free(p);return 0;}
+		memcpy(p->name,name,len);p->name[len]=0;
 	}
-	if(!cJSON_Buf_Copy_Char(buf,'}'))return 0;
-	return buf->buf;	
+	if (!name && index==-1) {for (tail=&parent->child;*tail;tail=&(*tail)->next);*tail=p;}	/* [*] last, so an index step is found first. */
+	else {p->next=parent->child;parent->child=p;}
+	return p;
 }
 
-/* Get Array size/item / object item. */
-int    cJSON_GetArraySize(cJSON *array)							{cJSON *c=array->child;int i=0;while(c)i++,c=c->next;return i;}
-cJSON *cJSON_GetArrayItem(cJSON *array,int item)				{cJSON *c=array->child;  while (c && item>0) item--,c=c->next; return c;}
-cJSON *cJSON_GetObjectItemV2(cJSON *object,const char *string,int*pos=NULL){
-	int hash_code=BKDRHash(string),i=0;
-	cJSON *c=object->child;
-	while (c){
-		if(c->hash_string==-1){c->hash_string=BKDRHash(c->string);}
-		if(c->hash_string==hash_code && !cJSON_strcasecmp(c->string,string)){if(pos)*pos=i;return c;}
-		c=c->next;
-		i++;
+/* Add the steps below src to dst. */
+static int projection_merge(cJSON_Projection *dst,const cJSON_Projection *src)
+{
+	cJSON_Projection *d;const cJSON_Projection *c;
+	dst->whole|=src->whole;
+	for (c=src->child;c;c=c->next)
+		if (!(d=projection_step(dst,c->name,c->name?(int)strlen(c->name):0,c->index)) || projection_merge(d,c)) return -1;	/* memory fail */
+	return 0;
+}
+
+/* An element matched by both [n] and [*] takes the steps of both: copy the [*] steps under each [n] beside it. */
+static int projection_spread(cJSON_Projection *proj)
+{
+	cJSON_Projection *p,*all=0;
+	for (p=proj->child;p;p=p->next) if (!p->name && p->index==-1) all=p;
+	for (p=proj->child;p;p=p->next)
+		if ((all && !p->name && p->index!=-1 && projection_merge(p,all)) || projection_spread(p)) return -1;
+	return 0;
+}
+
+void cJSON_DeleteProjection(cJSON_Projection *proj)
+{
+	cJSON_Projection *next;
+	while (proj)
+	{
+		next=proj->next;
+		cJSON_DeleteProjection(proj->child);
+		if (proj->name) cJSON_free(proj->name);
+		cJSON_free(proj);
+		proj=next;
+	}
+}
+
+/* Paths look like "user.id", "events[*].ts" or "items[0]". An empty path keeps the whole document. */
+cJSON_Projection *cJSON_CompileProjection(const char **paths,int count)
+{
+	cJSON_Projection *root,*p;const char *s;int i,len;
+	if (!(root=(cJSON_Projection*)cJSON_malloc(sizeof(cJSON_Projection)))) return 0;
+	memset(root,0,sizeof(cJSON_Projection));
+	for (i=0;i<count;i++)
+	{
+		p=root;s=paths[i];
+		while (*s)
+		{
+			if (*s=='[')
+			{
+				if (s[1]=='*' && s[2]==']') {p=projection_step(p,0,0,-1);s+=3;}
+				else if (s[1]>='0' && s[1]<='9') {p=projection_step(p,0,0,atoi(s+1));while (*s && *s!=']') s++;if (*s) s++;}
+				else {cJSON_DeleteProjection(root);return 0;}	/* bad index. */
+			}
+			else
+			{
+				for (len=0;s[len] && s[len]!='.' && s[len]!='[';len++);
+				if (!len) {cJSON_DeleteProjection(root);return 0;}	/* empty name. */
+				p=projection_step(p,s,len,-1);s+=len;
+			}
+			if (!p) {cJSON_DeleteProjection(root);return 0;}	/* memory fail */
+			if (*s=='.') s++;
+		}
+		p->whole=1;
+	}
+	if (projection_spread(root)) {cJSON_DeleteProjection(root);return 0;}	/* memory fail */
+	return root;
+}
+
+static const char *parse_projected(cJSON *item,const char *value,const char *end,const cJSON_Projection *proj,int depth);
+
+/* Which step, if any, applies to the member/element; 0 means skip it. A step that cannot match the value is skipped too. */
+static const cJSON_Projection *projection_match(const cJSON_Projection *proj,const char *key,const char *keyend,int index,const char *value)
+{
+	const cJSON_Projection *p,*q;
+	for (p=proj->child;p;p=p->next)
+	{
+		if (key ? !(p->name && cursor_key_match(key,keyend,p->name)) : (p->name || (p->index!=-1 && p->index!=index))) continue;
+		if (p->whole) return p;
+		for (q=p->child;q;q=q->next) if ((*value=='{' && q->name) || (*value=='[' && !q->name)) return p;
 	}
+	return 0;
+}
+
+/* Skipped members and elements are checked as cJSON_Parse would read them, so both fail on the same text at the same
+   place. depth is how many containers value is in. */
+static const char *parse_projected(cJSON *item,const char *value,const char *end,const cJSON_Projection *proj,int depth)
+{
+	const cJSON_Projection *sub;const char *key=0,*keyend=0,*open=value;cJSON *child=0,*new_item;int index=0,saved;char close;
+	if (proj->whole)
+	{
+		saved=parse_depth;parse_depth=depth;
+		value=parse_bounded(item,value,end);
+		parse_depth=saved;
+		return value;
+	}
+	if (value>=end || (*value!='{' && *value!='[')) return parse_bounded(item,value,end);	/* a scalar has nothing to leave out. */
+	item->type=(*value=='{')?cJSON_Object:cJSON_Array;
+	close=(*value=='{')?'}':']';
+	value=skip_bounded(value+1,end);
+	if (value<end && *value==close) return value+1;
+	if (depth>=nesting_limit) {ep=open;return 0;}	/* too deep. */
+	while (value<end)
+	{
+		if (close=='}')
+		{
+			if (*value!='\"') {ep=value;return 0;}
+			key=value+1;
+			value=skip_string_checked(value,end);
+			keyend=value-1;
+			value=skip_bounded(value,end);
+			if (value>=end || *value!=':') {ep=value;return 0;}
+			value=skip_bounded(value+1,end);
+			if (value>=end) break;
+		}
+		if ((sub=projection_match(proj,key,keyend,index++,value)))
+		{
+			if (!(new_item=cJSON_New_Item())) return 0;	/* memory fail */
+			if (child) suffix_object(child,new_item); else item->child=new_item;
+			child=new_item;
+			if (key && !parse_key(child,key-1)) return 0;
+			value=parse_projected(child,value,end,sub,depth+1);
+		}
+		else value=skip_checked(value,end,depth+1);
+		value=skip_bounded(value,end);
+		if (!value || value>=end) break;
+		if (*value==close) return value+1;
+		if (*value!=',') {ep=value;return 0;}
+		value=skip_bounded(value+1,end);
+	}
+	if (value) ep=value;
+	return 0;
+}
+
+cJSON *cJSON_ParseProjected(const char *value,int len,const cJSON_Projection *proj)
+{
+	const char *end;cJSON *c;
+	ep=0;
+	if (!value || !proj) return 0;
+	end=value+(len<0?strlen(value):len);
+	if (!(c=cJSON_New_Item())) return 0;	/* memory fail */
+	if (!parse_projected(c,skip_bounded(value,end),end,proj,0)) {cJSON_Delete(c);return 0;}
 	return c;
 }
-cJSON *cJSON_GetObjectItem(cJSON *object,const char *string){return cJSON_GetObjectItemV2(object,string);}
 
-/* Utility for array list handling. */
-static void suffix_object(cJSON *prev,cJSON *item) {prev->next=item;item->prev=prev;}
-/* Utility for handling references. */
-static cJSON *create_reference(cJSON *item) {cJSON *ref=cJSON_New_Item();if (!ref) return 0;memcpy(ref,item,sizeof(cJSON));ref->string=0;ref->type|=cJSON_IsReference;ref->next=ref->prev=0;return ref;}
+/* Validation only: the full grammar, strictly, without building anything. */
+#define VALIDATE_LOCAL_DEPTH 4096
 
-/* Add item to array/object. */
-void   cJSON_AddItemToArray(cJSON *array, cJSON *item)						{cJSON *c=array->child;if (!item) return; if (!c) {array->child=item;} else {while (c && c->next) c=c->next; suffix_object(c,item);}}
-void   cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item)	{if (!item) return; if (item->string) cJSON_free(item->string);item->string=cJSON_strdup(string);cJSON_AddItemToArray(object,item);}
-void	cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)						{cJSON_AddItemToArray(array,create_reference(item));}
-void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item)	{cJSON_AddItemToObject(object,string,create_reference(item));}
+/* Length of the UTF-8 sequence at s, 0 if it is not well formed. */
+static int validate_utf8(const unsigned char *s,const unsigned char *end)
+{
+	int n,i;unsigned char lo=0x80,hi=0xBF;
+	if (*s<0x80) return 1;
+	else if (*s>=0xC2 && *s<=0xDF) n=2;
+	else if (*s>=0xE0 && *s<=0xEF) {n=3;if (*s==0xE0) lo=0xA0;else if (*s==0xED) hi=0x9F;}
+	else if (*s>=0xF0 && *s<=0xF4) {n=4;if (*s==0xF0) lo=0x90;else if (*s==0xF4) hi=0x8F;}
+	else return 0;
+	if (end-s<n) return 0;
+	if (s[1]<lo || s[1]>hi) return 0;	/* overlong, surrogate or past U+10FFFF. */
+	for (i=2;i<n;i++) if (s[i]<0x80 || s[i]>0xBF) return 0;
+	return n;
+}
 
-cJSON *cJSON_DetachItemFromArray(cJSON *array,int which)			{cJSON *c=array->child;while (c && which>0) c=c->next,which--; if (c) return cJSON_DetachItemFromParent(array,c);return 0;}
-void   cJSON_DeleteItemFromArray(cJSON *array,int which)			{cJSON_Delete(cJSON_DetachItemFromArray(array,which));}
-cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string) {cJSON *c=cJSON_GetObjectItemV2(object,string);if (c) return cJSON_DetachItemFromParent(object,c);return 0;}
-void   cJSON_DeleteItemFromObject(cJSON *object,const char *string) {cJSON_Delete(cJSON_DetachItemFromObject(object,string));}
-cJSON *cJSON_DetachItemFromParent(cJSON *object,cJSON *c)           {if (c->prev) c->prev->next=c->next;if (c->next) c->next->prev=c->prev;if (c==object->child) object->child=c->next;c->prev=c->next=0;return c;}
-void   cJSON_DeleteItemFromParent(cJSON *object,cJSON *c)			{cJSON_Delete(cJSON_DetachItemFromParent(object,c));}
+#ifdef __SSE2__
+/* Bit i set where byte i of v is lo..hi, or below hi, compared as signed chars: lo and hi lie in 0x81..0xFF. */
+#define byte_range(v,lo,hi) _mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(v,_mm_set1_epi8((char)((lo)-1))),_mm_cmplt_epi8(v,_mm_set1_epi8((char)((hi)+1)))))
+#define byte_below(v,hi) _mm_movemask_epi8(_mm_cmplt_epi8(v,_mm_set1_epi8((char)(hi))))
+#define byte_is(v,c) _mm_movemask_epi8(_mm_cmpeq_epi8(v,_mm_set1_epi8((char)(c))))
 
-/* Replace array/object items with new ones. */
-void   cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem)		{cJSON *c=array->child;while (c && which>0) c=c->next,which--;if (!c) return;
-	newitem->next=c->next;newitem->prev=c->prev;if (newitem->next) newitem->next->prev=newitem;
-	if (c==array->child) array->child=newitem; else newitem->prev->next=newitem;c->next=c->prev=0;cJSON_Delete(c);}
-void   cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem){int i=0;cJSON *c=cJSON_GetObjectItemV2(object,string,&i);if(c){if(newitem->string) cJSON_free(newitem->string);newitem->string=cJSON_strdup(string);cJSON_ReplaceItemInArray(object,i,newitem);}}
+/* validate_utf8 for the first limit bytes of v at once: every continuation byte must be one a lead byte before it asks
+   for, and the second bytes after E0, ED, F0 and F4 must keep to their narrower ranges. Returns how many bytes are whole
+   sequences, stopping at the lead of one that runs past limit; 0 when any is malformed, for the byte loop to find. */
+static int validate_utf8_block(__m128i v,int limit)
+{
+	unsigned keep=(1u<<limit)-1,cont,lead2,lead3,lead4,expect,bad;
+	cont=byte_below(v,0xC0);
+	lead2=byte_range(v,0xC2,0xDF)&keep;lead3=byte_range(v,0xE0,0xEF)&keep;lead4=byte_range(v,0xF0,0xF4)&keep;
+	if (_mm_movemask_epi8(v)&keep&~(cont|lead2|lead3|lead4)) return 0;	/* C0, C1, F5 and up. */
+	expect=((lead2|lead3|lead4)<<1)|((lead3|lead4)<<2)|(lead4<<3);
+	if ((cont&keep)!=(expect&keep)) return 0;
+	bad=((byte_is(v,0xE0)<<1)&byte_below(v,0xA0))|((byte_is(v,0xED)<<1)&byte_range(v,0xA0,0xBF))
+		|((byte_is(v,0xF0)<<1)&byte_below(v,0x90))|((byte_is(v,0xF4)<<1)&byte_range(v,0x90,0xBF));
+	if (bad&keep) return 0;	/* overlong, surrogate or past U+10FFFF. */
+	if (!(expect>>limit)) return limit;
+	return 31-__builtin_clz(lead2|lead3|lead4);
+}
+#endif
 
-/* Create basic types: */
-cJSON *cJSON_CreateNull()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_NULL;return item;}
-cJSON *cJSON_CreateTrue()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_True;return item;}
-cJSON *cJSON_CreateFalse()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_False;return item;}
-cJSON *cJSON_CreateBool(int b)					{cJSON *item=cJSON_New_Item();if(item)item->type=b?cJSON_True:cJSON_False;return item;}
-cJSON *cJSON_CreateNumber(double num)			{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_Number;item->valuedouble=num;item->valueint=(int)num;item->valueuint=(uint)num;}return item;}
-cJSON *cJSON_CreateString(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=cJSON_strdup(string);}return item;}
-cJSON *cJSON_CreateArray()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Array;return item;}
-cJSON *cJSON_CreateObject()						{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Object;return item;}
+/* Check the string at s, returns its end or 0 with *err on the offending byte. */
+static const unsigned char *validate_string(const unsigned char *s,const unsigned char *end,int options,const unsigned char **err)
+{
+	unsigned uc,uc2;int n;
+	s++;
+	while (1)
+	{
+#ifdef __SSE2__
+		/* 16 bytes at a time up to the next quote, backslash or control character, with their UTF-8 checked in the same
+		   pass; the byte loop below takes what is left. */
+		while (end-s>=16)
+		{
+			__m128i v=_mm_loadu_si128((const __m128i*)s);
+			__m128i special=_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8('\"')),_mm_cmpeq_epi8(v,_mm_set1_epi8('\\'))),
+				_mm_cmpeq_epi8(_mm_max_epu8(v,_mm_set1_epi8(31)),_mm_set1_epi8(31)));
+			int stop=_mm_movemask_epi8(special),limit,high;
+			if (!(stop|_mm_movemask_epi8(v))) {s+=16;continue;}	/* plain ASCII. */
+			limit=stop?__builtin_ctz(stop):16;high=_mm_movemask_epi8(v)&((1u<<limit)-1);
+			if (!(options&cJSON_Validate_UTF8) || !high) n=limit;
+			else if ((high>>__builtin_ctz(high))<16) {s+=__builtin_ctz(high);break;}	/* one sequence at most: cheaper byte by byte. */
+			else n=validate_utf8_block(v,limit);
+			s+=n;
+			if (!n || (n==limit && limit<16)) break;	/* at a special byte, or a malformed one. */
+		}
+#endif
+		if (s>=end) {*err=s;return 0;}	/* unterminated. */
+		if (*s=='\"') return s+1;
+		if (*s<32) {*err=s;return 0;}
+		if (*s>=0x80)
+		{
+			if (!(options&cJSON_Validate_UTF8)) {s++;continue;}
+			if (!(n=validate_utf8(s,end))) {*err=s;return 0;}
+			s+=n;continue;
+		}
+		if (*s!='\\') {s++;continue;}
+		if (end-s<2) {*err=s;return 0;}
+		switch (s[1])
+		{
+			case '\"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't': s+=2;break;
+			case 'u':
+				if (end-s<6 || (uc=parse_hex4((const char*)s+2))==0x10000) {*err=s;return 0;}
+				if (uc>=0xDC00 && uc<=0xDFFF) {*err=s;return 0;}	/* lone second-half of surrogate. */
+				if (uc>=0xD800 && uc<=0xDBFF)
+				{
+					if (end-s<12 || s[6]!='\\' || s[7]!='u') {*err=s;return 0;}	/* missing second-half of surrogate. */
+					uc2=parse_hex4((const char*)s+8);
+					if (uc2<0xDC00 || uc2>0xDFFF) {*err=s;return 0;}	/* invalid second-half of surrogate. */
+					s+=6;
+				}
+				s+=6;break;
+			default: *err=s;return 0;
+		}
+	}
+}
 
-/* Create Arrays: */
-cJSON *cJSON_CreateIntArray(int *numbers,int count)				{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateFloatArray(float *numbers,int count)			{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateDoubleArray(double *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateStringArray(const char **strings,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateString(strings[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+static const unsigned char *validate_number(const unsigned char *s,const unsigned char *end)
+{
+	if (s<end && *s=='-') s++;
+	if (s<end && *s=='0') s++;
+	else if (s<end && *s>='1' && *s<='9') while (s<end && *s>='0' && *s<='9') s++;
+	else return 0;
+	if (s<end && *s=='.')
+	{
+		if (++s>=end || *s<'0' || *s>'9') return 0;
+		while (s<end && *s>='0' && *s<='9') s++;
+	}
+	if (s<end && (*s=='e' || *s=='E'))
+	{
+		if (++s<end && (*s=='+' || *s=='-')) s++;
+		if (s>=end || *s<'0' || *s>'9') return 0;
+		while (s<end && *s>='0' && *s<='9') s++;
+	}
+	return s;
+}
+
+static const unsigned char *validate_skip(const unsigned char *s,const unsigned char *end) {while (s<end && (*s==' ' || *s=='\t' || *s=='\n' || *s=='\r')) s++;return s;}
+
+/* Returns -1 when start..end holds exactly one valid JSON text, otherwise the offset of the first error. Nesting is
+   tracked in a bit stack, one bit per level saying whether it is an object. It starts in *objects (bits of them); nesting
+   past that moves it to the heap, left in *objects for the caller to free. */
+static int validate_text(const unsigned char *start,const unsigned char *end,int options,unsigned int **objects,int *bits)
+{
+	const unsigned char *s,*err=0;
+	unsigned int *grown;int depth=0,is_object;
+	s=validate_skip(start,end);
+	while (1)
+	{
+		/* a value is expected at s. */
+		if (s>=end) return s-start;
+		switch (*s)
+		{
+			case '{': case '[':
+				if (depth>=nesting_limit) return s-start;	/* as deep as cJSON_Parse goes. */
+				if (depth>=*bits)
+				{
+					if (!(grown=(unsigned int*)cJSON_malloc(*bits/4))) return s-start;	/* memory fail */
+					memcpy(grown,*objects,*bits/8);
+					if (*bits>VALIDATE_LOCAL_DEPTH) cJSON_free(*objects);
+					*objects=grown;*bits*=2;
+				}
+				is_object=(*s=='{');
+				if (is_object) (*objects)[depth/32]|=1u<<(depth%32); else (*objects)[depth/32]&=~(1u<<(depth%32));
+				depth++;
+				s=validate_skip(s+1,end);
+				if (s<end && *s==(is_object?'}':']')) {s++;depth--;break;}	/* empty. */
+				if (!is_object) continue;
+				if (s>=end || *s!='\"' || !(s=validate_string(s,end,options,&err))) return (err?err:s)-start;
+				s=validate_skip(s,end);
+				if (s>=end || *s!=':') return s-start;
+				s=validate_skip(s+1,end);
+				continue;
+			case '\"':
+				if (!(s=validate_string(s,end,options,&err))) return err-start;
+				break;
+			case 't': if (end-s<4 || memcmp(s,"true",4)) return s-start;s+=4;break;
+			case 'f': if (end-s<5 || memcmp(s,"false",5)) return s-start;s+=5;break;
+			case 'n': if (end-s<4 || memcmp(s,"null",4)) return s-start;s+=4;break;
+			default:
+				{
+					const unsigned char *num=validate_number(s,end);
+					if (!num) return s-start;
+					s=num;
+				}
+				break;
+		}
+		/* after a value: separators and closers. */
+		while (1)
+		{
+			s=validate_skip(s,end);
+			if (!depth) return s==end?-1:(int)(s-start);
+			is_object=((*objects)[(depth-1)/32]>>((depth-1)%32))&1;
+			if (s<end && *s==(is_object?'}':']')) {s++;depth--;continue;}
+			if (s>=end || *s!=',') return s-start;
+			s=validate_skip(s+1,end);
+			if (is_object)
+			{
+				if (s>=end || *s!='\"' || !(s=validate_string(s,end,options,&err))) return (err?err:s)-start;
+				s=validate_skip(s,end);
+				if (s>=end || *s!=':') return s-start;
+				s=validate_skip(s+1,end);
+			}
+			break;
+		}
+	}
+}
+
+int cJSON_Validate(const char *value,int len,int options)
+{
+	unsigned int local[VALIDATE_LOCAL_DEPTH/32],*objects=local;int bits=VALIDATE_LOCAL_DEPTH,result;
+	if (!value) return 0;
+	result=validate_text((const unsigned char*)value,(const unsigned char*)value+(len<0?strlen(value):len),options,&objects,&bits);
+	if (objects!=local) cJSON_free(objects);
+	return result;
+}
+
+/* Tape documents: one flat array of 64-bit entries plus a string buffer, read in place without any nodes.
+   An entry is the cJSON type in the top byte and a payload below it:
+     array/object: bits 0-31 index just past the whole container (so skipping it is O(1)), bits 32-55 item count,
+     string:       offset of the string in the string buffer, stored as a 4 byte length, the bytes and a NUL,
+     number:       nothing, the next entry holds the bits of the double.
+   Object members are a key string entry followed by the value. */
+struct cJSON_Tape {
+	cJSON_Buf tape;
+	cJSON_Buf strings;
+};
+
+#define TAPE_ENTRY(tape,i)	(((unsigned long long*)(tape)->tape.buf)[i])
+#define TAPE_SIZE(tape)		((int)((tape)->tape.offset/sizeof(unsigned long long)))
+#define TAPE_TYPE(e)		((int)((e)>>56))
+#define TAPE_JUMP(e)		((int)((e)&0xFFFFFFFFULL))
+#define TAPE_COUNT(e)		((int)(((e)>>32)&0xFFFFFF))
+#define TAPE_MAX_COUNT		0xFFFFFF
+
+static int tape_emit(cJSON_Tape *tape,int type,unsigned long long payload)
+{
+	int i=TAPE_SIZE(tape);
+	if (cJSON_Buf_Check(&tape->tape,sizeof(unsigned long long))<0) return -1;
+	TAPE_ENTRY(tape,i)=((unsigned long long)type<<56)|payload;
+	tape->tape.offset+=sizeof(unsigned long long);
+	return i;
+}
+
+static int tape_number(cJSON_Tape *tape,double d)
+{
+	unsigned long long bits;
+	memcpy(&bits,&d,sizeof(bits));
+	if (tape_emit(tape,cJSON_Number,0)<0) return -1;
+	if (cJSON_Buf_Check(&tape->tape,sizeof(unsigned long long))<0) return -1;
+	TAPE_ENTRY(tape,TAPE_SIZE(tape))=bits;
+	tape->tape.offset+=sizeof(unsigned long long);
+	return 0;
+}
+
+/* Append a string of len bytes to the string buffer and the tape. */
+static int tape_string(cJSON_Tape *tape,const char *str,int len)
+{
+	int offset=tape->strings.offset;
+	if (cJSON_Buf_Check(&tape->strings,len+5)<0) return -1;
+	memcpy(tape->strings.buf+offset,&len,4);
+	memcpy(tape->strings.buf+offset+4,str,len);tape->strings.buf[offset+4+len]=0;
+	tape->strings.offset+=len+5;
+	return tape_emit(tape,cJSON_String,offset);
+}
+
+/* Unescape the string at str straight into the string buffer. */
+static const char *tape_parse_string(cJSON_Tape *tape,const char *str)
+{
+	int offset=tape->strings.offset,len;
+	if (!str) return 0;
+	if (*str!='\"') {ep=str;return 0;}	/* not a string! */
+	if (cJSON_Buf_Check(&tape->strings,string_length(str)+5)<0) return 0;
+	str=unescape_string(str,tape->strings.buf+offset+4,&len);
+	memcpy(tape->strings.buf+offset,&len,4);
+	tape->strings.offset+=len+5;
+	if (tape_emit(tape,cJSON_String,offset)<0) return 0;
+	return str;
+}
+
+static int tape_next(const cJSON_Tape *tape,int i)
+{
+	unsigned long long e=TAPE_ENTRY(tape,i);
+	switch (TAPE_TYPE(e))
+	{
+		case cJSON_Array: case cJSON_Object: return TAPE_JUMP(e);
+		case cJSON_Number: return i+2;
+	}
+	return i+1;
+}
+
+/* The same grammar as parse_value, written to the tape. Open containers are kept on a frame stack by their index. */
+static const char *parse_tape(cJSON_Tape *tape,const char *value)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth=0,i;
+	cJSON number;
+
+	while (1)
+	{
+		if (!value)						goto fail;	/* Fail on null. */
+		if (*value=='\"')				{ value=tape_parse_string(tape,value); }
+		else if (*value=='-' || (*value>='0' && *value<='9'))	{ value=parse_number(&number,value);if (tape_number(tape,number.valuedouble)<0) goto fail; }
+		else if (*value=='{' || *value=='[')
+		{
+			const char *open=value;int type=(*value=='{')?cJSON_Object:cJSON_Array;
+			if ((i=tape_emit(tape,type,0))<0) goto fail;
+			value=skip(value+1);
+			if (*value==((type==cJSON_Object)?'}':']')) {value++;TAPE_ENTRY(tape,i)|=(unsigned long long)(i+1);}	/* empty array/object. */
+			else
+			{
+				if (!(top=push_frame(&stack,&size,depth,local))) {ep=open;goto fail;}	/* too deep, or memory fail */
+				depth++;
+				top->depth=i;
+				TAPE_ENTRY(tape,i)|=1ULL<<32;
+				if (type==cJSON_Object)
+				{
+					value=skip(tape_parse_string(tape,skip(value)));
+					if (!value) goto fail;
+					if (*value!=':') {ep=value;goto fail;}	/* fail! */
+					value++;
+				}
+				value=skip(value);
+				continue;
+			}
+		}
+		else if (!strncmp(value,"null",4))	{ if (tape_emit(tape,cJSON_NULL,0)<0) goto fail;value+=4; }
+		else if (!strncmp(value,"false",5))	{ if (tape_emit(tape,cJSON_False,0)<0) goto fail;value+=5; }
+		else if (!strncmp(value,"true",4))	{ if (tape_emit(tape,cJSON_True,0)<0) goto fail;value+=4; }
+		else { ep=value;goto fail; }	/* failure. */
+		if (!value) goto fail;
+
+		while (depth)
+		{
+			unsigned long long *open;
+			top=stack+depth-1;
+			open=&TAPE_ENTRY(tape,top->depth);
+			value=skip(value);
+			if (*value==',')
+			{
+				if (TAPE_COUNT(*open)<TAPE_MAX_COUNT) *open+=1ULL<<32;
+				value=skip(value+1);
+				if (TAPE_TYPE(*open)==cJSON_Object)
+				{
+					value=skip(tape_parse_string(tape,value));
+					if (!value) goto fail;
+					if (*value!=':') {ep=value;goto fail;}	/* fail! */
+					value=skip(value+1);
+				}
+				break;
+			}
+			if (*value!=((TAPE_TYPE(*open)==cJSON_Object)?'}':']')) {ep=value;goto fail;}	/* malformed. */
+			*open|=(unsigned long long)TAPE_SIZE(tape);
+			value++;depth--;	/* end of array/object */
+		}
+		if (!depth) break;
+	}
+	if (stack!=local) cJSON_free(stack);
+	return value;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	return 0;
+}
+
+static cJSON_Tape *tape_new(int size)
+{
+	cJSON_Tape *tape=(cJSON_Tape*)cJSON_malloc(sizeof(cJSON_Tape));
+	if (!tape) return 0;
+	if (cJSON_Buf_Init(&tape->tape,size/2+64,0)<0) {cJSON_free(tape);return 0;}
+	if (cJSON_Buf_Init(&tape->strings,size/2+64,0)<0) {cJSON_Buf_Clear(&tape->tape);cJSON_free(tape);return 0;}
+	return tape;
+}
+
+void cJSON_DeleteTape(cJSON_Tape *tape)
+{
+	if (!tape) return;
+	cJSON_Buf_Clear(&tape->tape);
+	cJSON_Buf_Clear(&tape->strings);
+	cJSON_free(tape);
+}
+
+cJSON_Tape *cJSON_ParseTape(const char *value)
+{
+	cJSON_Tape *tape;
+	ep=0;
+	if (!(tape=tape_new(strlen(value)))) return 0;	/* memory fail */
+	if (!parse_tape(tape,skip(value))) {cJSON_DeleteTape(tape);return 0;}
+	return tape;
+}
+
+int cJSON_Tape_Type(const cJSON_Tape *tape,int item)
+{
+	if (item<0 || item>=TAPE_SIZE(tape)) return -1;
+	return TAPE_TYPE(TAPE_ENTRY(tape,item));
+}
+
+int cJSON_Tape_GetArraySize(const cJSON_Tape *tape,int array)
+{
+	unsigned long long e;int i,n=0;
+	if (cJSON_Tape_Type(tape,array)!=cJSON_Array && cJSON_Tape_Type(tape,array)!=cJSON_Object) return 0;
+	e=TAPE_ENTRY(tape,array);
+	if (TAPE_COUNT(e)<TAPE_MAX_COUNT) return TAPE_COUNT(e);
+	for (i=array+1;i<TAPE_JUMP(e);i=tape_next(tape,i)) n++;	/* too many to store, count them. */
+	return TAPE_TYPE(e)==cJSON_Object?n/2:n;
+}
+
+int cJSON_Tape_GetArrayItem(const cJSON_Tape *tape,int array,int item)
+{
+	int i,end;
+	if (cJSON_Tape_Type(tape,array)!=cJSON_Array && cJSON_Tape_Type(tape,array)!=cJSON_Object) return -1;
+	end=TAPE_JUMP(TAPE_ENTRY(tape,array));
+	for (i=array+1;i<end;i=tape_next(tape,i))
+	{
+		if (TAPE_TYPE(TAPE_ENTRY(tape,array))==cJSON_Object) i++;	/* step over the key. */
+		if (!item--) return i;
+	}
+	return -1;
+}
+
+int cJSON_Tape_GetObjectItem(const cJSON_Tape *tape,int object,const char *string)
+{
+	int i,end;
+	if (cJSON_Tape_Type(tape,object)!=cJSON_Object) return -1;
+	end=TAPE_JUMP(TAPE_ENTRY(tape,object));
+	for (i=object+1;i<end;i=tape_next(tape,i+1))
+		if (!cJSON_strcasecmp(cJSON_Tape_String(tape,i),string)) return i+1;
+	return -1;
+}
+
+const char *cJSON_Tape_String(const cJSON_Tape *tape,int item)
+{
+	if (cJSON_Tape_Type(tape,item)!=cJSON_String) return 0;
+	return tape->strings.buf+(TAPE_ENTRY(tape,item)&0xFFFFFFFFFFFFFFULL)+4;
+}
+
+double cJSON_Tape_Number(const cJSON_Tape *tape,int item)
+{
+	double d;
+	if (cJSON_Tape_Type(tape,item)!=cJSON_Number) return 0;
+	memcpy(&d,&TAPE_ENTRY(tape,item+1),sizeof(d));
+	return d;
+}
+
+/* Build a mutable tree from the value at item. Frames hold the container being filled and, in depth, where it ends. */
+cJSON *cJSON_Tape_ToTree(const cJSON_Tape *tape,int item)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth=0,type,i=item;
+	cJSON *root=0,*c;const char *key=0;
+
+	if (cJSON_Tape_Type(tape,item)<0) return 0;
+	while (1)
+	{
+		key=(depth && stack[depth-1].item->type==cJSON_Object)?cJSON_Tape_String(tape,i++):0;
+		type=TAPE_TYPE(TAPE_ENTRY(tape,i));
+		if (!(c=cJSON_New_Item())) goto fail;	/* memory fail */
+		c->type=type;
+		if (type==cJSON_Number) set_number(c,cJSON_Tape_Number(tape,i));
+		else if (type==cJSON_True) set_true(c);
+		else if (type==cJSON_String && set_valuestring(c,cJSON_Tape_String(tape,i),strlen(cJSON_Tape_String(tape,i)))) {cJSON_Delete(c);goto fail;}
+		if (depth)
+		{
+			top=stack+depth-1;
+			if (key && set_key(c,key)) {cJSON_Delete(c);goto fail;}
+			if (top->child) suffix_object(top->child,c); else top->item->child=c;
+			top->child=c;
+		}
+		else root=c;
+		if ((type==cJSON_Array || type==cJSON_Object) && TAPE_JUMP(TAPE_ENTRY(tape,i))>i+1)
+		{
+			if (!(top=push_frame(&stack,&size,depth,local))) goto fail;
+			depth++;
+			top->item=c;top->child=0;top->depth=TAPE_JUMP(TAPE_ENTRY(tape,i));
+			i++;
+			continue;
+		}
+		i=tape_next(tape,i);
+		while (depth && i>=stack[depth-1].depth) depth--;	/* closed. */
+		if (!depth) break;
+	}
+	if (stack!=local) cJSON_free(stack);
+	return root;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	cJSON_Delete(root);
+	return 0;
+}
+
+/* Lay a tree out as a tape. Frames hold the container, the child being written and, in depth, its open entry. */
+cJSON_Tape *cJSON_Tape_FromTree(cJSON *item)
+{
+	cJSON_Frame local[FRAME_LOCAL],*stack=local,*top;int size=FRAME_LOCAL,depth=0,i,type;
+	cJSON_Tape *tape;
+
+	if (!item || !(tape=tape_new(1024))) return 0;
+	while (1)
+	{
+		if (depth && (stack[depth-1].item->type&255)==cJSON_Object && tape_string(tape,item->string?item->string:"",item->string?strlen(item->string):0)<0) goto fail;
+		switch (type=(item->type)&255)
+		{
+			case cJSON_Number:	if (tape_number(tape,cJSON_GetNumberValue(item))<0) goto fail;break;
+			case cJSON_String:	if (tape_string(tape,item->valuestring,strlen(item->valuestring))<0) goto fail;break;
+			case cJSON_Raw:		if (!parse_tape(tape,skip(item->valuestring))) goto fail;break;
+			case cJSON_Array: case cJSON_Object:
+				if ((i=tape_emit(tape,type,0))<0) goto fail;
+				if (item->child)
+				{
+					if (!(top=push_frame(&stack,&size,depth,local))) goto fail;	/* too deep, or memory fail */
+					depth++;
+					top->item=item;top->child=item->child;top->depth=i;
+					item=item->child;
+					continue;
+				}
+				TAPE_ENTRY(tape,i)|=(unsigned long long)(i+1);
+				break;
+			case cJSON_NULL: case cJSON_False: case cJSON_True:
+				if (tape_emit(tape,type,0)<0) goto fail;
+				break;
+			default: goto fail;
+		}
+		while (depth)
+		{
+			unsigned long long *open;
+			top=stack+depth-1;
+			open=&TAPE_ENTRY(tape,top->depth);
+			if (TAPE_COUNT(*open)<TAPE_MAX_COUNT) *open+=1ULL<<32;
+			if ((top->child=top->child->next)) break;
+			*open|=(unsigned long long)TAPE_SIZE(tape);
+			depth--;
+		}
+		if (!depth) break;
+		item=top->child;
+	}
+	if (stack!=local) cJSON_free(stack);
+	return tape;
+fail:
+	if (stack!=local) cJSON_free(stack);
+	cJSON_DeleteTape(tape);
+	return 0;
+}
+
+cJSON *cJSON_ParseWithIntern(const char *value,cJSON_InternTable *table)
+{
+	cJSON_InternTable *saved=intern_table;cJSON *c;
+	intern_table=table;
+	c=cJSON_Parse(value);
+	intern_table=saved;
+	return c;
+}
+
+cJSON *cJSON_ParseWithStats(const char *value,cJSON_ParseStats *stats)
+{
+	cJSON_ParseStats *saved=parse_stats;cJSON *c;
+	memset(stats,0,sizeof(cJSON_ParseStats));
+	parse_stats=stats;
+	c=cJSON_Parse(value);
+	parse_stats=saved;
+	return c;
+}
+
+cJSON *cJSON_ParseWithOpts(const char *value,int options)
+{
+	int saved=parse_options;cJSON *c;
+	parse_options=options;
+	c=cJSON_Parse(value);
+	parse_options=saved;
+	return c;
+}
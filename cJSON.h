@@ -23,6 +23,8 @@
 #ifndef cJSON__h
 #define cJSON__h
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -36,13 +38,36 @@ extern "C"
 #define cJSON_String 4
 #define cJSON_Array 5
 #define cJSON_Object 6
+#define cJSON_Raw 7
 	
 #define cJSON_IsReference 256
+#define cJSON_IsShared 512
 
 
 typedef unsigned int uint;
 
+/* Build policies, the same for the library and everything including this header:
+   cJSON_COMPACT      smaller nodes, see below.
+   cJSON_SLAB         cJSON_Parse puts a document's strings and keys in one block with the root node instead of a malloc each;
+                      they go when the root is deleted, so an item detached from a parsed tree must not outlive it. Nodes are
+                      still a malloc each.
+   cJSON_ARENA        cJSON_Parse takes a document's nodes, strings and keys from a few growing chunks kept with the root; the
+                      same rule applies, and items deleted from the tree only give their memory back with the root.
+   cJSON_PRINT_CACHE  see cJSON_SetPrintCache.
+   cJSON_ALLOC_STATS  count allocations, see cJSON_GetAllocStats.
+   cJSON_TRACE        latency histograms, see cJSON_TraceSnapshot.
+   usermem, allmem and allmem_c build this code with their policies and keep their old calls, and arena builds it with
+   cJSON_ARENA; see the cJSON.h in each. */
+
+/* Default arguments for C++ callers; C callers pass everything. */
+#ifdef __cplusplus
+#define cJSON_DEFAULT(value) =value
+#else
+#define cJSON_DEFAULT(value)
+#endif
+
 /* The cJSON structure: */
+#ifndef cJSON_COMPACT
 typedef struct cJSON {
 	struct cJSON *next,*prev;	/* next/prev allow you to walk array/object chains. Alternatively, use GetArraySize/GetArrayItem/GetObjectItem */
 	struct cJSON *child;		/* An array or object item will have a child pointer pointing to a chain of the items in the array/object. */
@@ -50,28 +75,191 @@ typedef struct cJSON {
 	int type;					/* The type of the item, as above. */
 	
 	char *valuestring;			/* The item's string, if type==cJSON_String */
-	int valueint;				/* The item's number, if type==cJSON_Number */
-	double valuedouble;			/* The item's number, if type==cJSON_Number */
-	uint valueuint;             /* The item's number, if type==cJSON_Number */
+	union {
+		struct {
+			int valueint;		/* The item's number, if type==cJSON_Number */
+			uint valueuint;     /* The item's number, if type==cJSON_Number */
+			double valuedouble;	/* The item's number, if type==cJSON_Number */
+		};
+		char valueinline[16];	/* Strings under 16 bytes are stored here; valuestring or string then points at it. */
+	};
 	char *string;				/* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
 	int hash_string;            /* the hash code for string, for compare fast*/
+	int allocate_type;			/* Which of string/valuestring the item owns or keeps inline. */
+#ifdef cJSON_PRINT_CACHE
+	struct cJSON *parent;		/* The array/object holding the item, kept for invalidating print caches. */
+	struct cJSON_PrintCache *cache;	/* Printed text of the item, see cJSON_SetPrintCache. */
+#endif
+} cJSON;
+#else
+/* Compact layout, build everything with -DcJSON_COMPACT: the payload is a union and there are no int copies of numbers,
+   40 bytes a node on 64-bit, 32 with -DcJSON_NO_PREV as well (then walk from the parent; Detach/Replace do it for you). */
+typedef struct cJSON {
+	struct cJSON *next;			/* next allows you to walk array/object chains. */
+#ifndef cJSON_NO_PREV
+	struct cJSON *prev;
+#endif
+	union {
+		struct cJSON *child;	/* if type==cJSON_Array or cJSON_Object */
+		char *valuestring;		/* if type==cJSON_String */
+		double valuedouble;		/* if type==cJSON_Number */
+	};
+	char *string;				/* The item's name string, if this item is in an object. */
+	int hash_string;            /* the hash code for string, for compare fast*/
+	unsigned short type;		/* The type of the item, as above, with the cJSON_IsReference flag. */
+	unsigned short allocate_type;	/* Which of string/valuestring the item owns. */
+#ifdef cJSON_PRINT_CACHE
+	struct cJSON *parent;
+	struct cJSON_PrintCache *cache;
+#endif
 } cJSON;
+#endif
+
+/* Read a number whatever the layout, raw number text (cJSON_Parse_RawNumbers) included. */
+extern double cJSON_GetNumberValue(cJSON *item);
+#define cJSON_GetValueDouble(c) cJSON_GetNumberValue(c)
+#define cJSON_GetValueInt(c) ((int)cJSON_GetNumberValue(c))
+#define cJSON_GetValueUint(c) ((uint)cJSON_GetNumberValue(c))
+/* Change a number; use this rather than the fields, which raw numbers and the compact layout don't keep. */
+extern void   cJSON_SetNumberValue(cJSON *item,double num);
+/* Change a string's text to a copy of string; likewise use this rather than valuestring, which may point into the node.
+   References are left alone. Returns 0, or -1 on failure. */
+extern int    cJSON_SetValuestring(cJSON *item,const char *string);
 
 typedef struct cJSON_Hooks {
       void *(*malloc_fn)(size_t sz);
       void (*free_fn)(void *ptr);
 } cJSON_Hooks;
 
-/* Supply malloc, realloc and free functions to cJSON */
+/* Supply malloc and free functions to cJSON. Everything it allocates goes through them, printed text and cJSON_Buf
+   buffers included, so free what it hands back with the same free. */
 extern void cJSON_InitHooks(cJSON_Hooks* hooks);
 
+/* Allocation counters for the calling thread, kept when built with -DcJSON_ALLOC_STATS. Memory freed on another thread than
+   the one that allocated it shows up in that thread's counters, so bytes_live only adds up over all threads. Printed text
+   handed to the caller counts as freed when it is handed over, as _Take strings count as allocated when taken. */
+typedef struct cJSON_AllocStats {
+	long allocs,frees;			/* Nodes, strings and everything else from the cJSON_InitHooks malloc, _Take strings included. */
+	long bytes_live,bytes_peak;	/* Of those, by malloc_usable_size; 0 with other hooks. */
+	long buf_grows;				/* Print buffer reallocs, */
+	long buf_copied;			/* and the bytes they had to carry over. */
+} cJSON_AllocStats;
+/* Copy the counters to stats. Returns 0, or -1 (stats zeroed) when they are not compiled in. */
+extern int    cJSON_GetAllocStats(cJSON_AllocStats *stats);
+extern void   cJSON_ResetAllocStats(void);
+/* The counters as a JSON object. Free the char* when finished; 0 when they are not compiled in. */
+extern char  *cJSON_PrintAllocStats(void);
+
+/* Latency tracing, kept when built with -DcJSON_TRACE: cJSON_Parse, cJSON_ParseParallel, the prints and cJSON_Delete are
+   timed into lock-free per-thread histograms, a set for each message type. Snapshots add up every thread's. A print that
+   fails is not timed. */
+#define cJSON_Trace_Parse 0			/* All of a cJSON_Parse or cJSON_ParseParallel that succeeded. */
+#define cJSON_Trace_ParseAlloc 1	/* The part of such a parse spent allocating, when it ran on one thread; the rest is tokenizing. */
+#define cJSON_Trace_Print 2
+#define cJSON_Trace_Delete 3
+#define cJSON_Trace_ParseError 4	/* All of a parse that failed, kept out of the two above. */
+#define cJSON_Trace_Phases 5
+#define cJSON_TRACE_TYPES 8
+typedef struct cJSON_TraceStats {
+	unsigned long long count;
+	double p50,p99,p999,max;	/* Nanoseconds, to within 12.5%. */
+} cJSON_TraceStats;
+/* Called after every timed phase, on the thread that ran it. */
+typedef void (*cJSON_TraceHook)(int phase,int type,long long ns,void *ctx);
+/* The message type (0 to cJSON_TRACE_TYPES-1) the calling thread's next calls are counted under. */
+extern void   cJSON_TraceSetType(int type);
+extern void   cJSON_SetTraceHook(cJSON_TraceHook hook,void *ctx);
+/* Percentiles for one type and phase. Returns 0, or -1 (stats zeroed) on bad arguments or when tracing is not compiled in. */
+extern int    cJSON_TraceSnapshot(int type,int phase,cJSON_TraceStats *stats);
+
+/* A growing print buffer the caller owns; the text goes at offset. */
+typedef struct cJSON_Buf{
+   char * buf;
+   int len;
+   int offset;
+}cJSON_Buf;
+
+extern int cJSON_Buf_Init(cJSON_Buf*buf,int size,int offset);
+extern void cJSON_Buf_Clear(cJSON_Buf*buf);
+
+/* Default nesting depth at which parse and print fail cleanly. */
+#define cJSON_NESTING_LIMIT 10000
+/* Change the nesting limit for parse and print, <=0 restores the default. */
+extern void cJSON_SetNestingLimit(int depth);
+
 
 /* Supply a block of JSON, and this returns a cJSON object you can interrogate. Call cJSON_Delete when finished. */
 extern cJSON *cJSON_Parse(const char *value);
-/* Render a cJSON entity to text for transfer/storage. Free the char* when finished. */
-extern char  *cJSON_Print(cJSON *item,int padding=0, int estimate=16*1024);
+/* Parse a whole file. 0 if it can't be read or parsed. */
+extern cJSON *cJSON_LoadFromFile(const char *filename);
+/* Parse a document whose root is one large array, spreading the elements over threads. Same result and error pointer as cJSON_Parse. */
+extern cJSON *cJSON_ParseParallel(const char *value,int threads);
+/* Render a cJSON entity to text for transfer/storage. Free the char* when finished. padding bytes are left free before the text;
+   estimate is the size to start the buffer at, or 0 to go by the size of the thread's recent prints of a similar shape
+   (an object or not, with about as many children). */
+extern char  *cJSON_Print(cJSON *item,int padding cJSON_DEFAULT(0), int estimate cJSON_DEFAULT(0));
 /* Render a cJSON entity to text for transfer/storage without any formatting. Free the char* when finished. */
-extern char  *cJSON_PrintUnformatted(cJSON *item,int padding=0, int estimate=16*1024);
+extern char  *cJSON_PrintUnformatted(cJSON *item,int padding cJSON_DEFAULT(0), int estimate cJSON_DEFAULT(0));
+/* Recent print sizes, for sizing the next buffer: keep one zeroed sizer per call site (or per message type) so a small
+   response is not sized after a large one. Fine to share between threads. */
+typedef struct cJSON_PrintSizer {
+	int average,deviation;
+} cJSON_PrintSizer;
+extern char  *cJSON_PrintSized(cJSON *item,int fmt,cJSON_PrintSizer *sizer);
+/* Render formatted (fmt=1) or not into buf, from its offset on and 0 terminated, growing it as needed. Returns buf->buf, 0 on failure;
+   buf stays yours to cJSON_Buf_Clear. With buf=0 this is cJSON_Print/cJSON_PrintUnformatted. */
+extern char  *cJSON_PrintBuf(cJSON *item,int fmt,cJSON_Buf *buf);
+/* Render a cJSON entity with head bytes reserved before the text and tail bytes after it (e.g. for a length prefix and a checksum).
+   The text starts at *offset and is *len bytes, followed by a 0 and then the tail. Free the char* when finished. */
+extern char  *cJSON_PrintFramed(cJSON *item,int fmt,int head,int tail,int *offset,int *len);
+/* Print into this thread's retained buffer: no malloc or free once it has grown to fit. Returns the text (*len bytes,
+   zero terminated), valid until the next cJSON_PrintView on the thread; do not free it. The buffer is freed when the
+   thread exits; call cJSON_ReleasePrintView to hand the memory back sooner, e.g. when the thread goes idle. */
+extern const char *cJSON_PrintView(cJSON *item,int fmt,int *len);
+extern void cJSON_ReleasePrintView(void);
+/* Print caching, build everything with -DcJSON_PRINT_CACHE: an array/object with the cache enabled keeps its printed text and is copied
+   instead of walked next time. The Add/Detach/Replace/Delete calls, cJSON_SetNumberValue and cJSON_SetValuestring drop the caches
+   above what they change; after changing an item directly, call cJSON_InvalidatePrintCache on it. Printing fills the caches and
+   links the items under them to their parents, so never print a tree holding a cache from two threads at once; trees without one
+   print read-only.
+   Returns 0, or -1 on failure. */
+extern int    cJSON_SetPrintCache(cJSON *item,int enable);
+extern void   cJSON_InvalidatePrintCache(cJSON *item);
+
+/* Print item as an iovec list for writev/sendmsg. Strings and raw values of at least min_ref bytes (<=0 for a default) that need no
+   escaping are pointed at in place rather than copied, so leave the tree alone until the data is sent. Free with cJSON_DeleteIov. */
+struct iovec;
+typedef struct cJSON_Iov {
+	struct iovec *iov;			/* count pieces, len bytes in all. */
+	int count;
+	size_t len;
+	char *text;					/* The printed text the pieces not referenced point into. */
+} cJSON_Iov;
+extern cJSON_Iov *cJSON_PrintIov(cJSON *item,int fmt,int min_ref);
+extern void   cJSON_DeleteIov(cJSON_Iov *iov);
+
+/* A writer prints JSON from calls instead of from a tree, byte for byte what cJSON_Print (fmt=1) or cJSON_PrintUnformatted (fmt=0) would
+   make of the same tree. In an object call Key before each value. Every call returns 0, or -1 once anything failed or was out of place. */
+typedef struct cJSON_Writer cJSON_Writer;
+/* Where a stream writer hands its output, at least chunk bytes at a time (<=0 for a default). Return -1 to stop the writer. */
+typedef int (*cJSON_Sink)(void *ctx,const char *data,int len);
+extern cJSON_Writer *cJSON_CreateWriter(int fmt);
+extern cJSON_Writer *cJSON_CreateStreamWriter(int fmt,cJSON_Sink sink,void *ctx,int chunk);
+extern int    cJSON_Writer_BeginObject(cJSON_Writer *w);
+extern int    cJSON_Writer_EndObject(cJSON_Writer *w);
+extern int    cJSON_Writer_BeginArray(cJSON_Writer *w);
+extern int    cJSON_Writer_EndArray(cJSON_Writer *w);
+extern int    cJSON_Writer_Key(cJSON_Writer *w,const char *key);
+extern int    cJSON_Writer_String(cJSON_Writer *w,const char *string);
+extern int    cJSON_Writer_Int(cJSON_Writer *w,int num);
+extern int    cJSON_Writer_Double(cJSON_Writer *w,double num);
+extern int    cJSON_Writer_Bool(cJSON_Writer *w,int b);
+extern int    cJSON_Writer_Null(cJSON_Writer *w);
+/* Already serialized JSON, and a whole tree, as values. */
+extern int    cJSON_Writer_Raw(cJSON_Writer *w,const char *text);
+extern int    cJSON_Writer_Item(cJSON_Writer *w,cJSON *item);
+/* Check the document is complete, flush a stream writer, and free w. *out (if out is given) gets the text of a buffer writer; free it when finished. */
+extern int    cJSON_FinishWriter(cJSON_Writer *w,char **out);
 /* Delete a cJSON entity and all subentities. */
 extern void   cJSON_Delete(cJSON *c);
 
@@ -82,7 +270,95 @@ extern cJSON *cJSON_GetArrayItem(cJSON *array,int item);
 /* Get item "string" from object. Case insensitive. */
 extern cJSON *cJSON_GetObjectItem(cJSON *object,const char *string);
 
-/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
+/* A cursor is a position in unparsed text; nothing is built or copied until cJSON_Cursor_Parse. The text must outlive the cursor. */
+typedef struct cJSON_Cursor {
+	const char *value;			/* Start of the value the cursor is on. */
+	const char *end;			/* End of the text. */
+} cJSON_Cursor;
+
+/* Point a cursor at the root value of text. len<0 means text is NUL terminated. Returns 0, or -1 on failure. */
+extern int    cJSON_Cursor_Init(cJSON_Cursor *cur,const char *value,int len);
+/* The cJSON type of the value under the cursor, -1 if it is not a value. */
+extern int    cJSON_Cursor_Type(const cJSON_Cursor *cur);
+/* Move to member "string" / element "item", skipping everything before it. out may be cur. Returns 0, or -1 if missing or malformed. */
+extern int    cJSON_Cursor_Get(const cJSON_Cursor *cur,const char *string,cJSON_Cursor *out);
+extern int    cJSON_Cursor_Index(const cJSON_Cursor *cur,int item,cJSON_Cursor *out);
+/* Number of items in the array/object under the cursor, -1 on failure. */
+extern int    cJSON_Cursor_Size(const cJSON_Cursor *cur);
+/* Build (and fully validate) the value under the cursor. Call cJSON_Delete when finished. */
+extern cJSON *cJSON_Cursor_Parse(const cJSON_Cursor *cur);
+
+/* A compiled set of paths for cJSON_ParseProjected. */
+typedef struct cJSON_Projection cJSON_Projection;
+
+/* Compile paths such as "user.id" or "events[*].ts" once, reuse for many parses. Returns 0 on a bad path. */
+extern cJSON_Projection *cJSON_CompileProjection(const char **paths,int count);
+extern void   cJSON_DeleteProjection(cJSON_Projection *proj);
+/* Parse only the subtrees named by the projection, everything else is skipped unbuilt. len<0 means NUL terminated. Call cJSON_Delete when finished. */
+extern cJSON *cJSON_ParseProjected(const char *value,int len,const cJSON_Projection *proj);
+
+/* Options for cJSON_Validate. */
+#define cJSON_Validate_UTF8 1		/* Also reject strings that are not well-formed UTF-8; with SSE2, 16 bytes are checked at a time. */
+
+/* Check that text is one strict JSON value without building anything; it only allocates for nesting past 4096 levels.
+   len<0 means NUL terminated. Returns -1 when valid, otherwise the byte offset of the first error.
+   The grammar is RFC 8259's, strictly, with cJSON_SetNestingLimit's depth: whatever passes, cJSON_Parse accepts too.
+   cJSON_Parse is more lenient, so the reverse does not hold: it also takes 01, 1.e5, a lone -, lone surrogate escapes,
+   unknown escapes, control characters in strings and text after the value, all of which fail here. */
+extern int    cJSON_Validate(const char *value,int len,int options);
+
+/* A read-only document laid out flat: a tape of 64-bit entries and a string buffer. Items are tape indexes, the root is 0. */
+typedef struct cJSON_Tape cJSON_Tape;
+
+/* Parse text into a tape instead of a tree, 0 on failure (see cJSON_GetErrorPtr). Call cJSON_DeleteTape when finished. */
+extern cJSON_Tape *cJSON_ParseTape(const char *value);
+extern void   cJSON_DeleteTape(cJSON_Tape *tape);
+/* The cJSON type of item, -1 if item is not on the tape. */
+extern int    cJSON_Tape_Type(const cJSON_Tape *tape,int item);
+/* Like cJSON_GetArraySize/GetArrayItem/GetObjectItem; items that are missing are -1. Skipping a subtree is O(1). */
+extern int    cJSON_Tape_GetArraySize(const cJSON_Tape *tape,int array);
+extern int    cJSON_Tape_GetArrayItem(const cJSON_Tape *tape,int array,int item);
+extern int    cJSON_Tape_GetObjectItem(const cJSON_Tape *tape,int object,const char *string);
+/* The value of a string/number item, pointing into the tape's own buffer. */
+extern const char *cJSON_Tape_String(const cJSON_Tape *tape,int item);
+extern double cJSON_Tape_Number(const cJSON_Tape *tape,int item);
+/* Convert between tapes and mutable trees when editing is needed. */
+extern cJSON *cJSON_Tape_ToTree(const cJSON_Tape *tape,int item);
+extern cJSON_Tape *cJSON_Tape_FromTree(cJSON *item);
+
+/* A table of shared object keys: parsed documents point at one copy of each name instead of allocating their own. */
+typedef struct cJSON_InternTable cJSON_InternTable;
+
+/* Holds up to max_keys names (<=0 for a default), later new names are allocated per item as usual. Not thread safe: use one per thread.
+   The table must outlive every document parsed with it. */
+extern cJSON_InternTable *cJSON_CreateInternTable(int max_keys);
+extern void   cJSON_DeleteInternTable(cJSON_InternTable *table);
+/* The shared copy of string; passing it to cJSON_GetObjectItem matches on the pointer. 0 if the table is full. */
+extern const char *cJSON_Intern(cJSON_InternTable *table,const char *string);
+/* Parse with keys taken from table, or set a default table for every parse on the calling thread (0 to stop). */
+extern cJSON *cJSON_ParseWithIntern(const char *value,cJSON_InternTable *table);
+extern void   cJSON_SetInternTable(cJSON_InternTable *table);
+
+/* Parse options. RawNumbers: numbers keep pointing at their text in value, which must outlive the tree; they print it back verbatim
+   and are only converted when read with cJSON_GetValueDouble/Int/Uint, until cJSON_SetNumberValue. cJSON_Duplicate copies the
+   text, so a duplicate does not need value. */
+#define cJSON_Parse_RawNumbers 1
+extern cJSON *cJSON_ParseWithOpts(const char *value,int options);
+
+/* What a document held, counted while it is parsed. */
+typedef struct cJSON_ParseStats {
+	int nodes;							/* Values, arrays and objects included. */
+	int max_depth;						/* Deepest array/object nesting, 0 for a lone scalar. */
+	int strings,numbers;				/* String and number values. */
+	long string_bytes;					/* Text of string values and keys as written, quotes left out. */
+	int largest_array,largest_object;	/* Most elements in one array, members in one object. */
+} cJSON_ParseStats;
+/* cJSON_Parse filling in stats as well. After a failed parse they cover the text up to the error. */
+extern cJSON *cJSON_ParseWithStats(const char *value,cJSON_ParseStats *stats);
+
+/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds.
+   The error is kept per thread: this reports the last parse on the calling thread, never one running on another. The threads
+   cJSON_ParseParallel starts hand their error back to the thread that called it. */
 extern const char *cJSON_GetErrorPtr();
 	
 /* These calls create a cJSON item of the appropriate type. */
@@ -94,6 +370,11 @@ extern cJSON *cJSON_CreateNumber(double num);
 extern cJSON *cJSON_CreateString(const char *string);
 extern cJSON *cJSON_CreateArray();
 extern cJSON *cJSON_CreateObject();
+/* String items without the copy: _Take owns string (allocated with the cJSON_InitHooks malloc) and frees it, _Const borrows one that outlives the item. */
+extern cJSON *cJSON_CreateStringTake(char *string);
+extern cJSON *cJSON_CreateStringConst(const char *string);
+/* Already serialized JSON, printed as it is. len<0 means text is NUL terminated; with validate!=0 it must pass cJSON_Validate or 0 is returned. */
+extern cJSON *cJSON_CreateRaw(const char *text,int len,int validate);
 
 /* These utilities create an Array of count items. */
 extern cJSON *cJSON_CreateIntArray(int *numbers,int count);
@@ -101,13 +382,32 @@ extern cJSON *cJSON_CreateFloatArray(float *numbers,int count);
 extern cJSON *cJSON_CreateDoubleArray(double *numbers,int count);
 extern cJSON *cJSON_CreateStringArray(const char **strings,int count);
 
+/* Duplicate will create a new, identical cJSON item to the one you pass, in new memory that will need to be released with cJSON_Delete.
+   With recurse!=0 the children come too. The copy is a single allocation, so nodes detached from it must not outlive it. */
+extern cJSON *cJSON_Duplicate(cJSON *item,int recurse);
+
 /* Append item to the specified array/object. */
 extern void cJSON_AddItemToArray(cJSON *array, cJSON *item);
 extern void	cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item);
+/* Same, but the key is taken over or borrowed like cJSON_CreateStringTake/Const instead of copied. */
+extern void	cJSON_AddItemToObjectTake(cJSON *object,char *string,cJSON *item);
+extern void	cJSON_AddItemToObjectConst(cJSON *object,const char *string,cJSON *item);
 /* Append reference to item to the specified array/object. Use this when you want to add an existing cJSON to a new cJSON, but don't want to corrupt your existing cJSON. */
 extern void cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
 extern void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item);
 
+/* Shared subtrees. cJSON_CreateShared takes over a detached array/object and returns a handle to it, cJSON_Share another handle; add and
+   delete handles like any item, the tree goes with the last one. Printing, duplicating and cJSON_GetArraySize see straight through.
+   Anything that can lead to a change gives the handle a private copy first, as does cJSON_Unshare (0, or -1 on memory fail): adding,
+   detaching or replacing its children, and cJSON_GetArrayItem/GetObjectItem, so whatever they return can be changed at any depth.
+   Walking handle->child reads the shared tree itself; do not change what it reaches. The last handle takes the tree over instead of
+   copying it when its nodes are its own. Counting is thread safe. In the compact layout every handle is simply a copy. */
+extern cJSON *cJSON_CreateShared(cJSON *tree);
+extern cJSON *cJSON_Share(cJSON *handle);
+extern int    cJSON_Unshare(cJSON *handle);
+#define cJSON_AddSharedToObject(object,name,handle)	cJSON_AddItemToObject(object, name, cJSON_Share(handle))
+#define cJSON_AddSharedToArray(array,handle)	cJSON_AddItemToArray(array, cJSON_Share(handle))
+
 /* Remove/Detatch items from Arrays/Objects. */
 extern cJSON *cJSON_DetachItemFromArray(cJSON *array,int which);
 extern void   cJSON_DeleteItemFromArray(cJSON *array,int which);
@@ -125,6 +425,8 @@ extern void cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *ne
 #define cJSON_AddFalseToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateFalse())
 #define cJSON_AddNumberToObject(object,name,n)	cJSON_AddItemToObject(object, name, cJSON_CreateNumber(n))
 #define cJSON_AddStringToObject(object,name,s)	cJSON_AddItemToObject(object, name, cJSON_CreateString(s))
+#define cJSON_AddRawToObject(object,name,s)	cJSON_AddItemToObject(object, name, cJSON_CreateRaw(s, -1, 0))
+#define cJSON_AddStringToObjectConst(object,name,s)	cJSON_AddItemToObjectConst(object, name, cJSON_CreateStringConst(s))
 
 #define cJSON_IsObject(c) (c&&c->type==cJSON_Object)
 #define cJSON_IsBool(c) (c&&(c->type==cJSON_False||c->type==cJSON_True))
@@ -132,10 +434,15 @@ extern void cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *ne
 #define cJSON_IsArray(c) (c&&c->type==cJSON_Array)
 #define cJSON_IsString(c) (c&&c->type==cJSON_String)
 #define cJSON_IsNull(c) (c&&c->type==cJSON_NULL)
+#define cJSON_IsRaw(c) (c&&c->type==cJSON_Raw)
 #define cJSON_IsValid(c) (c)
 
 #ifdef __cplusplus
 }
+
+/* Printing into a caller buffer under the usual names, as usermem and allmem had it. */
+inline char *cJSON_Print(cJSON *item,cJSON_Buf *buf)				{return cJSON_PrintBuf(item,1,buf);}
+inline char *cJSON_PrintUnformatted(cJSON *item,cJSON_Buf *buf)	{return cJSON_PrintBuf(item,0,buf);}
 #endif
 
 #endif
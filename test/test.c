@@ -0,0 +1,733 @@
+/* cJSON regression checks. The makefile builds this once against each variant (TEST_VARIANT names it) under
+   AddressSanitizer and runs them all; a variant fails when any check does, and prints each failed check.
+   Usage: test */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include "cJSON.h"
+
+#ifndef TEST_VARIANT
+#define TEST_VARIANT "root"
+#endif
+
+static int checks,failures;
+#define check(cond) do {checks++;if (!(cond)) {failures++;fprintf(stderr,"%s:%d: %s: check failed: %s\n",__FILE__,__LINE__,TEST_VARIANT,#cond);}} while (0)
+
+/* Unformatted text of item, or a copy of "(null)"; free it. */
+static char *text(cJSON *item)
+{
+	char *out=item?cJSON_PrintBuf(item,0,0):0;
+	return out?out:strdup("(null)");
+}
+
+/* Whether a and b print the same. */
+static int same(cJSON *a,cJSON *b)
+{
+	char *x=text(a),*y=text(b);int ok=!strcmp(x,y);
+	free(x);free(y);
+	return ok;
+}
+
+/* A top-level array of count copies of element, big enough for cJSON_ParseParallel to use its threads. */
+static char *repeat(const char *element,int count)
+{
+	int len=strlen(element),i;char *out=(char*)malloc(count*(len+1)+2),*ptr=out;
+	*ptr++='[';
+	for (i=0;i<count;i++) {if (i) *ptr++=',';memcpy(ptr,element,len);ptr+=len;}
+	*ptr++=']';*ptr=0;
+	return out;
+}
+
+/* cJSON_ParseParallel gives cJSON_Parse's tree and error, under the same nesting limit and intern table. */
+static void test_parallel(void)
+{
+	char *doc=repeat("{\"id\":12345,\"name\":\"some name\",\"tags\":[\"a\",\"b\",[1,2,{\"x\":null}]],\"ok\":true}",8000);
+	char *deep=repeat("[[1]]",60000);
+	cJSON *serial,*parallel;cJSON_InternTable *table;const char *error;
+
+	serial=cJSON_Parse(doc);parallel=cJSON_ParseParallel(doc,4);
+	check(serial && parallel && same(serial,parallel));
+	cJSON_Delete(serial);cJSON_Delete(parallel);
+
+	cJSON_SetNestingLimit(2);
+	serial=cJSON_Parse(deep);parallel=cJSON_ParseParallel(deep,4);
+	check(!serial && !parallel);
+	cJSON_Delete(serial);cJSON_Delete(parallel);
+	cJSON_SetNestingLimit(3);
+	serial=cJSON_Parse(deep);parallel=cJSON_ParseParallel(deep,4);
+	check(serial && parallel && same(serial,parallel));
+	cJSON_Delete(serial);cJSON_Delete(parallel);
+	memcpy(strstr(deep+strlen(deep)*9/10,",[[1]],[[1]]"),",[[[1]]],[1]",12);	/* one element too deep, in the last thread's share. */
+	serial=cJSON_Parse(deep);error=cJSON_GetErrorPtr();
+	parallel=cJSON_ParseParallel(deep,4);
+	check(!serial && !parallel && error && cJSON_GetErrorPtr()==error);
+	cJSON_SetNestingLimit(0);
+
+	table=cJSON_CreateInternTable(0);
+	cJSON_SetInternTable(table);
+	parallel=cJSON_ParseParallel(doc,4);
+	cJSON_SetInternTable(0);
+	check(parallel && cJSON_GetArrayItem(parallel,7000)->child->string==cJSON_Intern(table,"id"));
+	cJSON_Delete(parallel);
+	cJSON_DeleteInternTable(table);
+
+	free(doc);free(deep);
+}
+
+/* Nested count levels deep: [[[...1...]]]. */
+static char *nested(int count)
+{
+	char *out=(char*)malloc(2*count+2);
+	memset(out,'[',count);out[count]='1';memset(out+count+1,']',count);out[2*count+1]=0;
+	return out;
+}
+
+/* Whatever cJSON_Validate passes cJSON_Parse accepts, at any nesting limit; the lenient extras only Parse takes. */
+static void test_validate(void)
+{
+	static const char *strict[]={"{}","[]","0","-0.5e+10","\"\\ud83d\\ude00\"","{\"a\":[true,false,null,\"\\n\"]}"," [1 , {\"b\" : -1E3}]\r\n"};
+	static const char *lenient[]={"01","1.e5","-","\"\\ud800\"","\"\\q\"","[1] x"};
+	/* well formed, then malformed at their first byte: overlong, surrogate, past U+10FFFF, stray and cut short. */
+	static const char *good[]={"\xc3\xa9","\xe2\x82\xac","\xf0\x9f\x98\x80","\xed\x9f\xbf","\xf4\x8f\xbf\xbf","\xe0\xa0\x80"};
+	static const char *bad[]={"\xc0\xaf","\xe0\x9f\xbf","\xed\xa0\x80","\xf4\x90\x80\x80","\xf5\x80\x80\x80","\x80","\xe2\x82z"};
+	char *deep=nested(5000),text[64];cJSON *c,*raw;unsigned i,at,ok;
+
+	for (i=0;i<sizeof(strict)/sizeof(strict[0]);i++)
+	{
+		c=cJSON_Parse(strict[i]);
+		check(cJSON_Validate(strict[i],-1,cJSON_Validate_UTF8)==-1 && c);
+		cJSON_Delete(c);
+	}
+	for (i=0;i<sizeof(lenient)/sizeof(lenient[0]);i++)
+	{
+		c=cJSON_Parse(lenient[i]);
+		check(cJSON_Validate(lenient[i],-1,0)>=0 && c);
+		cJSON_Delete(c);
+	}
+
+	/* each sequence at every offset of a string long enough for the 16 byte blocks, next to a few others. */
+	for (ok=1,i=0;i<sizeof(good)/sizeof(good[0]);i++) for (at=1;at<40;at++)
+	{
+		memset(text,'a',sizeof(text));text[0]='\"';
+		memcpy(text+at,good[i],strlen(good[i]));memcpy(text+at+8,"\xc3\xa9\xe2\x82\xac",5);text[60]='\"';
+		ok&=cJSON_Validate(text,61,cJSON_Validate_UTF8)==-1;
+	}
+	check(ok);
+	for (ok=1,i=0;i<sizeof(bad)/sizeof(bad[0]);i++) for (at=1;at<40;at++)
+	{
+		memset(text,'a',sizeof(text));text[0]='\"';
+		if (at>=6) memcpy(text+1,"\xc3\xa9\xd0\xb6",4);
+		memcpy(text+at,bad[i],strlen(bad[i]));text[60]='\"';
+		ok&=cJSON_Validate(text,61,cJSON_Validate_UTF8)==(int)at && cJSON_Validate(text,61,0)==-1;
+	}
+	check(ok);
+
+	c=cJSON_Parse(deep);raw=cJSON_CreateRaw(deep,-1,1);
+	check(c && cJSON_Validate(deep,-1,0)==-1 && raw);
+	cJSON_Delete(c);cJSON_Delete(raw);
+	cJSON_SetNestingLimit(4999);
+	c=cJSON_Parse(deep);
+	check(!c && cJSON_Validate(deep,-1,0)==4999);
+	cJSON_SetNestingLimit(5000);
+	c=cJSON_Parse(deep);
+	check(c && cJSON_Validate(deep,-1,0)==-1);
+	cJSON_Delete(c);
+	cJSON_SetNestingLimit(0);
+	free(deep);
+}
+
+/* item through a tape and back prints as item does. */
+static int tape_round_trip(cJSON *item)
+{
+	cJSON_Tape *tape=cJSON_Tape_FromTree(item);cJSON *back=tape?cJSON_Tape_ToTree(tape,0):0;
+	int ok=back && same(item,back);
+	cJSON_Delete(back);cJSON_DeleteTape(tape);
+	return ok;
+}
+
+/* Objects flagged as references or shared keep their keys on the tape. */
+static void test_tape(void)
+{
+	cJSON *object=cJSON_Parse("{\"a\":1,\"b\":[\"x\",{\"c\":null}],\"d\":\"long enough to live outside the node\"}");
+	cJSON *outer=cJSON_CreateArray(),*shared=cJSON_CreateShared(cJSON_Duplicate(object,1));
+
+	check(tape_round_trip(object));
+	cJSON_AddItemReferenceToArray(outer,object);
+	cJSON_AddItemReferenceToArray(outer,cJSON_GetObjectItem(object,"b"));
+	check(tape_round_trip(outer));
+	check(tape_round_trip(shared));
+	cJSON_AddItemToArray(outer,cJSON_Share(shared));
+	check(tape_round_trip(outer));
+	cJSON_Delete(outer);cJSON_Delete(shared);cJSON_Delete(object);
+}
+
+/* Unsharing the last handle, and adding to it, leaves a tree of its own whatever the shared tree was allocated as:
+   node by node, one Duplicate block, or a parse (its strings, and in the arena variant its nodes, in the root's memory).
+   Items looked up through a handle are its own to change. */
+static void test_unshare(void)
+{
+	const char *json="{\"list\":[1,\"two\",{\"three\":\"a string too long to be inline\"}],\"name\":\"another long string value\"}";
+	const char *want="{\"list\":[1,\"two\",{\"three\":\"a string too long to be inline\"}],\"name\":\"another long string value\",\"n\":4}";
+	cJSON *trees[3],*handle,*other;char *out;int i;
+
+	trees[0]=cJSON_CreateObject();
+	cJSON_AddItemToObject(trees[0],"list",cJSON_Parse("[1,\"two\",{\"three\":\"a string too long to be inline\"}]"));
+	cJSON_AddItemToObject(trees[0],"name",cJSON_CreateString("another long string value"));
+	trees[1]=cJSON_Parse(json);
+	trees[2]=cJSON_Duplicate(trees[1],1);
+	for (i=0;i<3;i++)
+	{
+		handle=cJSON_CreateShared(trees[i]);
+		other=cJSON_Share(handle);
+		check(cJSON_Unshare(other)==0);	/* not the last: copies. */
+		cJSON_AddItemToObject(other,"n",cJSON_CreateNumber(4));
+		cJSON_AddItemToObject(handle,"n",cJSON_CreateNumber(4));	/* the last. */
+		cJSON_Delete(other);
+		out=text(handle);
+		check(!strcmp(out,want));
+		free(out);
+		cJSON_Delete(handle);
+	}
+
+	/* a change further down, reached by lookups through one handle, leaves the other handles' tree alone. */
+	handle=cJSON_CreateShared(cJSON_Parse(json));
+	other=cJSON_Share(handle);
+	cJSON_SetNumberValue(cJSON_GetArrayItem(cJSON_GetObjectItem(other,"list"),0),5);
+	cJSON_ReplaceItemInObject(cJSON_GetArrayItem(cJSON_GetObjectItem(other,"list"),2),"three",cJSON_CreateNull());
+	out=text(other);
+	check(!strcmp(out,"{\"list\":[5,\"two\",{\"three\":null}],\"name\":\"another long string value\"}"));
+	free(out);
+	out=text(handle);
+	check(!strcmp(out,json));
+	free(out);
+	cJSON_Delete(other);cJSON_Delete(handle);
+}
+
+/* Raw numbers in a copy outlive the text they were parsed from, and still print verbatim. */
+static void test_raw_numbers(void)
+{
+	const char *want="[12345678901234567890,1.50,{\"n\":-0.0e0}]";
+	char *json=strdup(want),*out;
+	cJSON *parsed=cJSON_ParseWithOpts(json,cJSON_Parse_RawNumbers),*copy=cJSON_Duplicate(parsed,1),*handle,*other;
+
+	handle=cJSON_CreateShared(cJSON_Duplicate(parsed,1));
+	other=cJSON_Share(handle);
+	cJSON_Unshare(other);	/* copies node by node. */
+	cJSON_Delete(parsed);
+	memset(json,' ',strlen(json));free(json);
+	out=text(copy);check(!strcmp(out,want));free(out);
+	out=text(other);check(!strcmp(out,want));free(out);
+	cJSON_SetNumberValue(cJSON_GetArrayItem(copy,1),2);
+	out=text(copy);check(!strcmp(out,"[12345678901234567890,2,{\"n\":-0.0e0}]"));free(out);
+	cJSON_Delete(copy);cJSON_Delete(other);cJSON_Delete(handle);
+}
+
+/* Editing a parsed tree: items deleted, replaced and added among the parsed ones, whichever allocator made them. */
+static void test_edit(void)
+{
+	cJSON *c=cJSON_Parse("{\"keep\":[1,2,3],\"drop\":\"a string long enough for the heap or slab\",\"swap\":{\"x\":1}}"),*detached;
+	char *out;
+	cJSON_DeleteItemFromObject(c,"drop");
+	cJSON_DeleteItemFromArray(cJSON_GetObjectItem(c,"keep"),1);
+	cJSON_ReplaceItemInObject(c,"swap",cJSON_CreateString("replaced"));
+	detached=cJSON_DetachItemFromArray(cJSON_GetObjectItem(c,"keep"),0);
+	cJSON_AddItemToObject(c,"added",cJSON_CreateNumber(5));
+	out=text(c);
+	check(!strcmp(out,"{\"keep\":[3],\"swap\":\"replaced\",\"added\":5}"));
+	free(out);
+	cJSON_Delete(detached);cJSON_Delete(c);
+}
+
+/* Whether the value under cur matches item all the way down, looking each member and element up both ways. */
+static int cursor_matches(const cJSON_Cursor *cur,cJSON *item)
+{
+	cJSON_Cursor sub;cJSON *parsed=cJSON_Cursor_Parse(cur),*c;int ok=same(parsed,item),i=0;
+	cJSON_Delete(parsed);
+	if (!ok || cJSON_Cursor_Type(cur)!=(item->type&255)) return 0;
+	if ((item->type&255)!=cJSON_Array && (item->type&255)!=cJSON_Object) return cJSON_Cursor_Size(cur)==-1;
+	if (cJSON_Cursor_Size(cur)!=cJSON_GetArraySize(item)) return 0;
+	for (c=item->child;c;c=c->next,i++)
+		if ((item->type&255)==cJSON_Object ? cJSON_Cursor_Get(cur,c->string,&sub) || !cursor_matches(&sub,cJSON_GetObjectItem(item,c->string))
+											: cJSON_Cursor_Index(cur,i,&sub) || !cursor_matches(&sub,cJSON_GetArrayItem(item,i))) return 0;
+	return cJSON_Cursor_Index(cur,i,&sub)==-1;
+}
+
+/* Cursors find what cJSON_GetObjectItem and cJSON_GetArrayItem find in the parsed tree, escaped keys included, and
+   stay inside the length they were given. */
+static void test_cursor(void)
+{
+	const char *doc="{\"id\":7,\"a\\\"b\":[1,2,{\"c\\\\d\":\"x\"}],\"\\u0041bc\":true,\"dup\":1,\"dup\":2,"
+					"\"nest\":{\"deep\":[[],{},null,-1.5e3,\"\\u00e9\"]}} {\"after\":1}";
+	int len=strstr(doc," {")-doc;
+	char *bounded=strndup(doc,len);
+	cJSON *tree=cJSON_Parse(bounded);
+	cJSON_Cursor cur,sub;
+
+	check(!cJSON_Cursor_Init(&cur,doc,len) && cursor_matches(&cur,tree));
+	check(!cJSON_Cursor_Get(&cur,"a\"b",&sub) && !cJSON_Cursor_Index(&sub,2,&sub) && !cJSON_Cursor_Get(&sub,"c\\d",&sub)
+		  && cJSON_Cursor_Type(&sub)==cJSON_String);
+	check(!cJSON_Cursor_Get(&cur,"Abc",&sub) && cJSON_Cursor_Type(&sub)==cJSON_True);
+	check(!cJSON_Cursor_Get(&cur,"dup",&sub) && cursor_matches(&sub,cJSON_GetObjectItem(tree,"dup")));
+	check(cJSON_Cursor_Get(&cur,"after",&sub)==-1 && !cJSON_GetObjectItem(tree,"after"));
+	check(cJSON_Cursor_Index(&cur,0,&sub)==-1 && !cJSON_Cursor_Get(&cur,"nest",&sub) && cJSON_Cursor_Index(&sub,0,&sub)==-1);
+	check(cJSON_Cursor_Init(&cur,doc,0)==-1);
+	check(!cJSON_Cursor_Init(&cur,doc,len-1) && !cJSON_Cursor_Parse(&cur) && cJSON_Cursor_Size(&cur)==-1);
+	cJSON_Delete(tree);free(bounded);
+}
+
+/* A projected parse prints just the paths asked for, overlapping ones merged, and fails where cJSON_Parse fails
+   whether the bad text is in a part it keeps or one it skips. */
+static void test_projection(void)
+{
+	const char *paths[]={"user.id","events[*].ts","events[1].kind","meta"};
+	const char *doc="{\"user\":{\"id\":1,\"name\":\"x\"},\"events\":[{\"ts\":1,\"kind\":\"a\"},{\"ts\":2,\"kind\":\"b\",\"x\":[1]},{\"kind\":\"c\"}],"
+					"\"other\":{\"a\":[1,2]},\"meta\":{\"m\":[true]}}";
+	const char *bad[]={"{\"user\":{\"id\":1},\"other\":{\"a\":[1,2}}","{\"user\":{\"id\":1},\"other\":tru}","{\"user\":{\"id\":1,}}",
+					   "{\"user\":{\"id\":1},\"events\":[{\"ts\":1},]}","{\"user\":{\"id\":1},\"other\":[\"a\" \"b\"]}",
+					   "{\"user\":{\"id\":1},\"other\":{\"k\" 1}}","{\"user\":{\"id\":1},\"other\":\"\\","{\"user\":{\"id\":1}"};
+	cJSON_Projection *proj=cJSON_CompileProjection(paths,4);
+	cJSON *projected=cJSON_ParseProjected(doc,-1,proj),*full;
+	const char *error;char *out=text(projected),*deep=nested(100);
+	unsigned i;int ok=1;
+
+	check(!strcmp(out,"{\"user\":{\"id\":1},\"events\":[{\"ts\":1},{\"ts\":2,\"kind\":\"b\"},{}],\"meta\":{\"m\":[true]}}"));
+	free(out);cJSON_Delete(projected);
+	for (i=0;i<sizeof(bad)/sizeof(*bad);i++)
+	{
+		projected=cJSON_ParseProjected(bad[i],-1,proj);error=cJSON_GetErrorPtr();
+		full=cJSON_Parse(bad[i]);
+		ok&=!projected && !full && error==cJSON_GetErrorPtr();
+		cJSON_Delete(projected);cJSON_Delete(full);
+	}
+	check(ok);
+	cJSON_SetNestingLimit(50);
+	projected=cJSON_ParseProjected(deep,-1,proj);error=cJSON_GetErrorPtr();
+	check(!projected && !cJSON_Parse(deep) && error==cJSON_GetErrorPtr());
+	cJSON_SetNestingLimit(0);
+	cJSON_DeleteProjection(proj);free(deep);
+}
+
+/* Write item call by call; with whole set, items below the top level go in with cJSON_Writer_Item. */
+static int write_tree(cJSON_Writer *w,cJSON *item,int whole)
+{
+	cJSON *c;int ok=1,is_object=(item->type&255)==cJSON_Object;
+	switch (item->type&255)
+	{
+		case cJSON_NULL:	return cJSON_Writer_Null(w);
+		case cJSON_False:	return cJSON_Writer_Bool(w,0);
+		case cJSON_True:	return cJSON_Writer_Bool(w,1);
+		case cJSON_Number:	return cJSON_Writer_Double(w,item->valuedouble);
+		case cJSON_String:	return cJSON_Writer_String(w,item->valuestring);
+		case cJSON_Raw:		return cJSON_Writer_Raw(w,item->valuestring);
+	}
+	ok=!(is_object?cJSON_Writer_BeginObject(w):cJSON_Writer_BeginArray(w));
+	for (c=item->child;ok && c;c=c->next)
+		ok=(!is_object || !cJSON_Writer_Key(w,c->string)) && !(whole?cJSON_Writer_Item(w,c):write_tree(w,c,0));
+	return (ok && !(is_object?cJSON_Writer_EndObject(w):cJSON_Writer_EndArray(w)))?0:-1;
+}
+
+static int sink_to(void *ctx,const char *data,int len)
+{
+	cJSON_Buf *buf=(cJSON_Buf*)ctx;
+	if (buf->offset+len>=buf->len) return -1;
+	memcpy(buf->buf+buf->offset,data,len);buf->offset+=len;buf->buf[buf->offset]=0;
+	return 0;
+}
+
+/* Strings of 15, 16 and 17 bytes, either side of the 16 byte inline buffer (the compact layout has none), as values and
+   keys: created, parsed, duplicated and deleted from under the copy, set with cJSON_SetValuestring, replaced and printed. */
+static void test_inline_strings(void)
+{
+	static const int lengths[]={15,16,17};
+	char str[3][18],want[256],*out;cJSON *object,*copy,*parsed,*item;int i,j,ok=1;
+
+	for (i=0;i<3;i++) {memset(str[i],'a'+i,lengths[i]);str[i][lengths[i]]=0;}
+	for (i=0;i<3;i++)
+	{
+		object=cJSON_CreateObject();
+		for (j=0;j<3;j++) cJSON_AddItemToObject(object,str[j],cJSON_CreateString(str[i]));
+		sprintf(want,"{\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\"}",str[0],str[i],str[1],str[i],str[2],str[i]);
+		out=text(object);ok&=!strcmp(out,want);free(out);
+		parsed=cJSON_Parse(want);
+		ok&=!cJSON_SetValuestring(cJSON_GetObjectItem(parsed,str[2]),str[i]) && same(parsed,object);
+		copy=cJSON_Duplicate(parsed,1);
+		cJSON_Delete(object);cJSON_Delete(parsed);
+		out=text(copy);ok&=!strcmp(out,want);free(out);
+		for (j=0;j<3;j++)
+		{
+			item=cJSON_GetObjectItem(copy,str[j]);
+			ok&=item && !strcmp(item->string,str[j]) && !strcmp(item->valuestring,str[i]);
+			ok&=!cJSON_SetValuestring(item,str[(i+j)%3]) && !strcmp(item->valuestring,str[(i+j)%3]);
+			ok&=!cJSON_SetValuestring(item,item->valuestring+1) && !strcmp(item->valuestring,str[(i+j)%3]+1);
+		}
+		cJSON_ReplaceItemInObject(copy,str[0],cJSON_CreateString(str[2]));
+		sprintf(want,"{\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\"}",str[0],str[2],str[1],str[(i+1)%3]+1,str[2],str[(i+2)%3]+1);
+		out=text(copy);ok&=!strcmp(out,want);free(out);
+		cJSON_Delete(copy);
+	}
+	check(ok);
+	item=cJSON_CreateNumber(1);
+	check(cJSON_SetValuestring(item,"x")==-1);
+	cJSON_Delete(item);
+}
+
+/* A writer, formatted or not, buffered or streamed, call by call or with cJSON_Writer_Item, writes what cJSON_PrintBuf prints. */
+static void test_writer(void)
+{
+	cJSON *tree=cJSON_Parse("{\"name\":\"a \\\"quoted\\\"\\n line\",\"n\":[0,-1,2.5,1e300,-0.125,123456789],\"empty\":{},\"none\":[],"
+							"\"deep\":{\"list\":[{\"x\":null,\"y\":[true,false]},[[],{}]],\"k\":{\"v\":\"\\u00e9\"}}}");
+	char *want,*got;int fmt,whole,ok=1;
+	char stream[4096];cJSON_Buf buf;cJSON_Writer *w;
+
+	cJSON_AddItemToObject(cJSON_GetObjectItem(tree,"deep"),"raw",cJSON_CreateRaw("[1, 2]",-1,0));
+	for (fmt=0;fmt<2;fmt++)
+	{
+		want=cJSON_PrintBuf(tree,fmt,0);
+		for (whole=0;whole<2;whole++)
+		{
+			w=cJSON_CreateWriter(fmt);got=0;
+			ok&=!write_tree(w,tree,whole) && !cJSON_FinishWriter(w,&got) && got && !strcmp(got,want);
+			free(got);
+			buf.buf=stream;buf.len=sizeof(stream);buf.offset=0;
+			w=cJSON_CreateStreamWriter(fmt,sink_to,&buf,16);
+			ok&=!write_tree(w,tree,whole) && !cJSON_FinishWriter(w,0) && !strcmp(stream,want);
+		}
+		check(ok);
+		free(want);
+	}
+	cJSON_Delete(tree);
+}
+
+/* The pieces of a cJSON_PrintIov, joined, are cJSON_PrintBuf's text, whatever is referenced in place. */
+static void test_iov(void)
+{
+	static const int min_refs[]={1,0,1000};
+	char *long_string=repeat("\"long enough to be sent in place\"",8);
+	cJSON *tree=cJSON_Parse("{\"short\":\"s\",\"escaped\":\"tab\\there \\\"quoted\\\" and long enough to reference\",\"n\":[1,2.5,-3],"
+							"\"nested\":{\"list\":[\"another string that is long enough\",null,true,{}]},\"empty\":[]}");
+	char *want,*got;cJSON_Iov *iov;int fmt,i,j,ok=1;size_t len;
+
+	cJSON_AddItemToObject(tree,"raw",cJSON_CreateRaw(long_string,-1,0));
+	cJSON_AddItemToObject(tree,"string",cJSON_CreateString(long_string));
+	for (fmt=0;fmt<2;fmt++)
+	{
+		want=cJSON_PrintBuf(tree,fmt,0);
+		for (i=0;i<3;i++)
+		{
+			if (!(iov=cJSON_PrintIov(tree,fmt,min_refs[i]))) {ok=0;continue;}
+			got=(char*)malloc(iov->len+1);
+			for (j=0,len=0;j<iov->count;j++) {memcpy(got+len,iov->iov[j].iov_base,iov->iov[j].iov_len);len+=iov->iov[j].iov_len;}
+			got[len]=0;
+			ok&=len==iov->len && len==strlen(want) && !strcmp(got,want) && (min_refs[i]!=1 || iov->count>1);
+			free(got);cJSON_DeleteIov(iov);
+		}
+		free(want);
+	}
+	check(ok);
+	cJSON_Delete(tree);free(long_string);
+}
+
+/* cJSON_PrintFramed leaves head bytes before PrintBuf's text and tail bytes after its 0; a length prefix written into the
+   head says exactly how long the payload is. */
+static void test_framed(void)
+{
+	static const int heads[]={0,4,9},tails[]={0,4,3};
+	char *doc=repeat("{\"id\":1,\"name\":\"framed\"}",50);
+	cJSON *tree=cJSON_Parse(doc);
+	char *want,*out;int fmt,i,offset,len,prefix,ok=1;
+
+	for (fmt=0;fmt<2;fmt++)
+	{
+		want=cJSON_PrintBuf(tree,fmt,0);
+		for (i=0;i<3;i++)
+		{
+			if (!(out=cJSON_PrintFramed(tree,fmt,heads[i],tails[i],&offset,&len))) {ok=0;continue;}
+			if (heads[i]>=4) {out[offset-4]=len>>24;out[offset-3]=len>>16;out[offset-2]=len>>8;out[offset-1]=len;}
+			memset(out+offset+len+1,0xAA,tails[i]);	/* AddressSanitizer checks the tail is there. */
+			prefix=heads[i]>=4?((unsigned char)out[offset-4]<<24|(unsigned char)out[offset-3]<<16|(unsigned char)out[offset-2]<<8|(unsigned char)out[offset-1]):len;
+			ok&=offset==heads[i] && len==(int)strlen(want) && prefix==(int)strlen(out+offset) && !memcmp(out+offset,want,len) && !out[offset+len];
+			free(out);
+		}
+		free(want);
+	}
+	check(ok);
+	check(!cJSON_PrintFramed(tree,0,-1,0,&offset,&len) && !cJSON_PrintFramed(tree,0,0,-1,&offset,&len));
+	cJSON_Delete(tree);free(doc);
+}
+
+#ifdef cJSON_PRINT_CACHE
+/* Whether item prints as a fresh copy of it does, formatted and not; the copy has no caches. */
+static int prints_fresh(cJSON *item)
+{
+	cJSON *copy=cJSON_Duplicate(item,1);
+	char *a=cJSON_PrintBuf(item,1,0),*b=cJSON_PrintBuf(copy,1,0);int ok=a && b && !strcmp(a,b);
+	free(a);free(b);
+	ok&=same(item,copy);
+	cJSON_Delete(copy);
+	return ok;
+}
+
+/* A cached print changes with the tree: after an Add deep below the cache, a Replace and cJSON_SetNumberValue. */
+static void test_print_cache(void)
+{
+	cJSON *root=cJSON_Parse("{\"a\":{\"list\":[1,2,{\"n\":3}]},\"b\":\"text\",\"c\":[true]}");
+	cJSON *a=cJSON_GetObjectItem(root,"a"),*list=cJSON_GetObjectItem(a,"list");
+	char *before=text(root),*after;
+
+	check(!cJSON_SetPrintCache(root,1) && !cJSON_SetPrintCache(a,1) && !cJSON_SetPrintCache(list,1));
+	check(prints_fresh(root) && prints_fresh(root));	/* the second print is from the caches. */
+	cJSON_AddItemToObject(cJSON_GetArrayItem(list,2),"added",cJSON_CreateString("deep"));
+	after=text(root);
+	check(strcmp(before,after) && prints_fresh(root));
+	free(before);before=after;
+	cJSON_ReplaceItemInObject(a,"list",cJSON_CreateNumber(9));
+	after=text(root);
+	check(strcmp(before,after) && prints_fresh(root));
+	free(before);before=after;
+	cJSON_SetNumberValue(cJSON_GetObjectItem(a,"list"),10);
+	after=text(root);
+	check(strcmp(before,after) && prints_fresh(root));
+	free(before);free(after);
+	cJSON_Delete(root);
+}
+#endif
+
+/* cJSON_ParseWithStats counts a fixed document the same in every variant, and covers the text up to an error. */
+static void test_parse_stats(void)
+{
+	cJSON_ParseStats stats;
+	cJSON *c=cJSON_ParseWithStats("{\"a\":[1,2,{\"b\":\"x\\ny\"}],\"c\":\"hello\",\"d\":null,\"e\":[]}",&stats);
+	check(c && stats.nodes==9 && stats.max_depth==3 && stats.strings==2 && stats.numbers==2 && stats.string_bytes==14
+		  && stats.largest_array==3 && stats.largest_object==4);
+	cJSON_Delete(c);
+	c=cJSON_ParseWithStats("[1,\"s\",[true,]]",&stats);
+	check(!c && stats.nodes==5 && stats.max_depth==2 && stats.strings==1 && stats.numbers==1 && stats.largest_array==0);
+}
+
+#ifdef cJSON_ALLOC_STATS
+/* How many allocations cJSON_Parse makes for the document in test_alloc_stats: a node each, plus the strings that do not
+   fit inline (keys only go inline before a container or null), or the slab's block, or a single arena chunk. */
+#if defined(cJSON_ARENA)
+#define STATS_DOC_ALLOCS 1
+#elif defined(cJSON_SLAB)
+#define STATS_DOC_ALLOCS 8
+#elif defined(cJSON_COMPACT)
+#define STATS_DOC_ALLOCS (8+6)
+#else
+#define STATS_DOC_ALLOCS (8+4)
+#endif
+
+/* The alloc stats count a fixed document's nodes and strings as each variant allocates them, and every byte comes back
+   with cJSON_Delete, after edits, copies and prints of a bigger one too; printed text stops counting when handed over. */
+static void test_alloc_stats(void)
+{
+	char *doc=repeat("{\"id\":12345,\"name\":\"a name longer than the inline buffer\",\"tags\":[\"x\",\"y\"]}",500),*out;
+	cJSON_AllocStats stats;cJSON_ParseStats parsed;cJSON *c,*copy;cJSON_Writer *w;
+
+	cJSON_ResetAllocStats();
+	c=cJSON_ParseWithStats("{\"key\":[1,2,{\"b\":\"a string longer than sixteen bytes\"}],\"short\":\"s\",\"a key longer than sixteen bytes\":null}",&parsed);
+	check(!cJSON_GetAllocStats(&stats) && parsed.nodes==8 && stats.allocs==STATS_DOC_ALLOCS && !stats.frees && stats.bytes_live>0);
+	cJSON_Delete(c);
+	check(!cJSON_GetAllocStats(&stats) && stats.frees==stats.allocs && stats.bytes_live==0 && stats.bytes_peak>0);
+
+	cJSON_ResetAllocStats();
+	c=cJSON_Parse(doc);
+	cJSON_DeleteItemFromArray(c,3);
+	cJSON_AddItemToArray(c,cJSON_CreateString("added after the parse, longer than inline"));
+	cJSON_SetValuestring(cJSON_GetObjectItem(cJSON_GetArrayItem(c,0),"name"),"changed, and longer than the inline buffer");
+	copy=cJSON_Duplicate(c,1);
+	out=cJSON_PrintBuf(c,1,0);free(out);	/* counted out when it was handed over. */
+	out=cJSON_PrintFramed(c,0,4,4,0,0);free(out);
+	w=cJSON_CreateWriter(0);
+	if (!cJSON_Writer_Item(w,c) && !cJSON_FinishWriter(w,&out)) free(out);
+	cJSON_Delete(c);
+	cJSON_Delete(copy);
+	check(!cJSON_GetAllocStats(&stats) && stats.bytes_live==0 && stats.allocs>0);
+	free(doc);
+}
+
+/* A sizer settles on a size it keeps seeing, after which the buffer never grows, and starts over on a far smaller one.
+   The thread's own sizers go by shape, so a small print after large ones on the thread gets a small buffer. */
+static void test_sizer(void)
+{
+	char *big=repeat("{\"id\":12345,\"name\":\"sized\"}",30000),*mid=repeat("{\"id\":12345,\"name\":\"sized\"}",300),*out;
+	cJSON *c=cJSON_Parse(big),*m=cJSON_Parse(mid),*small=cJSON_Parse("{\"a\":[1,2,3]}"),*less=cJSON_Duplicate(m,1);
+	cJSON_PrintSizer sizer={0,0};cJSON_AllocStats stats;int i,len=0,grows=0;
+
+	for (i=0;i<100;i++) cJSON_DeleteItemFromArray(less,0);
+	out=cJSON_PrintSized(less,0,&sizer);free(out);	/* a start two thirds of the way there. */
+	for (i=0;i<80;i++)
+	{
+		cJSON_ResetAllocStats();
+		out=cJSON_PrintSized(m,0,&sizer);
+		if (out) len=strlen(out);
+		free(out);
+		if (i>=40 && !cJSON_GetAllocStats(&stats)) grows+=stats.buf_grows;
+	}
+	check(len>0 && sizer.average==len && sizer.deviation<16 && !grows);
+	out=cJSON_PrintSized(small,0,&sizer);
+	check(out && sizer.average==(int)strlen(out));
+	free(out);
+
+	for (i=0;i<3;i++) {out=cJSON_PrintBuf(c,0,0);free(out);}
+	cJSON_ResetAllocStats();
+	out=cJSON_PrintBuf(small,0,0);free(out);
+	check(!cJSON_GetAllocStats(&stats) && stats.bytes_peak<65536);
+	cJSON_Delete(c);cJSON_Delete(m);cJSON_Delete(small);cJSON_Delete(less);
+	free(big);free(mid);
+}
+#endif
+
+#ifdef cJSON_TRACE
+static unsigned long long traced[cJSON_Trace_Phases];
+static void trace_counter(int phase,int type,long long ns,void *ctx) {if (type==*(int*)ctx && ns>=0) traced[phase]++;}
+
+/* Each timed call records its phase once under the thread's message type, failed parses apart from good ones, and the
+   snapshots agree with what the hook saw. */
+static void test_trace(void)
+{
+	static const unsigned long long want[cJSON_Trace_Phases]={2,1,6,3,2};
+	int type=5,phase,ok=1;
+	char *doc=repeat("{\"id\":1,\"name\":\"traced\"}",12000),*out;	/* past cJSON_ParseParallel's 256K, so it uses threads. */
+	cJSON *small,*big;cJSON_Iov *iov;cJSON_TraceStats stats;cJSON_Buf buf;
+
+	cJSON_SetTraceHook(trace_counter,&type);
+	cJSON_TraceSetType(type);
+	small=cJSON_Parse("{\"a\":[1,2,3]}");						/* Parse, ParseAlloc */
+	check(!cJSON_Parse("{\"a\":[1,2,}") && !cJSON_ParseParallel("[1,2,",4));	/* ParseError twice */
+	big=cJSON_ParseParallel(doc,4);							/* Parse */
+	out=cJSON_PrintBuf(small,0,0);free(out);				/* Print */
+	out=cJSON_PrintFramed(small,1,4,0,0,0);free(out);		/* Print */
+	if (!cJSON_Buf_Init(&buf,64,0)) {cJSON_PrintBuf(small,0,&buf);cJSON_Buf_Clear(&buf);}	/* Print */
+	cJSON_PrintView(small,0,0);cJSON_ReleasePrintView();	/* Print */
+	iov=cJSON_PrintIov(big,0,0);cJSON_DeleteIov(iov);		/* Print */
+	out=cJSON_PrintBuf(small,1,0);free(out);				/* Print */
+	cJSON_Delete(cJSON_Duplicate(small,1));					/* Delete */
+	cJSON_Delete(small);cJSON_Delete(big);					/* Delete twice */
+	cJSON_TraceSetType(0);
+	cJSON_SetTraceHook(0,0);
+	for (phase=0;phase<cJSON_Trace_Phases;phase++)
+	{
+		ok&=traced[phase]==want[phase] && !cJSON_TraceSnapshot(type,phase,&stats) && stats.count==want[phase];
+		ok&=stats.p50<=stats.p99 && stats.p99<=stats.p999 && stats.p999<=stats.max && stats.max>0;
+	}
+	check(ok);
+	check(cJSON_TraceSnapshot(type,cJSON_Trace_Phases,&stats)==-1 && cJSON_TraceSnapshot(cJSON_TRACE_TYPES,0,&stats)==-1);
+	free(doc);
+}
+#endif
+
+/* Hooks that count what is still allocated through them. Their pointers are offset into the block, so passing one to the
+   C library's realloc or free is an error AddressSanitizer reports. */
+static int hooked_live;
+static void *hooked_malloc(size_t size) {char *ptr=(char*)malloc(size+16);if (!ptr) return 0;hooked_live++;return ptr+16;}
+static void hooked_free(void *ptr) {hooked_live--;free((char*)ptr-16);}
+
+/* A copy of string from the malloc in use, for the _Take calls. */
+static char *take(const char *string,int hooked)
+{
+	char *out=hooked?(char*)hooked_malloc(strlen(string)+1):(char*)malloc(strlen(string)+1);
+	strcpy(out,string);
+	return out;
+}
+
+/* Items built with _Take and _Const strings, then changed, copied and deleted. */
+static void take_and_const(int hooked)
+{
+	static const char borrowed[]="a borrowed string, longer than the inline buffer";
+	cJSON *object=cJSON_CreateObject(),*copy,*item;
+
+	cJSON_AddItemToObjectTake(object,take("taken key, longer than the inline buffer",hooked),cJSON_CreateStringTake(take("taken value, longer than the inline buffer",hooked)));
+	cJSON_AddItemToObjectTake(object,take("k",hooked),cJSON_CreateStringConst(borrowed));
+	cJSON_AddItemToObjectConst(object,borrowed,cJSON_CreateStringTake(take("v",hooked)));
+	cJSON_AddItemToObjectConst(object,"const",cJSON_CreateStringConst("value"));
+	cJSON_AddItemToObjectTake(object,take("never added",hooked),0);
+	cJSON_AddItemToObject(object,"replaced",cJSON_CreateStringTake(take("replaced",hooked)));
+	cJSON_AddItemToObjectTake(object,take("detached",hooked),cJSON_CreateStringTake(take("detached value",hooked)));
+	copy=cJSON_Duplicate(object,1);
+	cJSON_SetValuestring(cJSON_GetObjectItem(object,"k"),"now a copy");
+	cJSON_SetValuestring(cJSON_GetObjectItem(object,borrowed),"also a copy");
+	cJSON_ReplaceItemInObject(object,"replaced",cJSON_CreateStringTake(take("replacement",hooked)));
+	item=cJSON_DetachItemFromObject(object,"detached");
+	cJSON_Delete(object);cJSON_Delete(item);
+	cJSON_Delete(copy);
+}
+
+/* _Take strings are freed once, with their item, whatever happened to it; _Const ones never are. With the counting hooks
+   every allocation comes back, and with the default malloc the alloc stats balance. */
+static void test_take_const(void)
+{
+	cJSON_Hooks hooks={hooked_malloc,hooked_free},plain={0,0};
+#ifdef cJSON_ALLOC_STATS
+	cJSON_AllocStats before,after;
+	cJSON_GetAllocStats(&before);
+	take_and_const(0);
+	cJSON_GetAllocStats(&after);
+	check(after.allocs-before.allocs==after.frees-before.frees && after.allocs>before.allocs && after.bytes_live==before.bytes_live);
+#endif
+	cJSON_InitHooks(&hooks);
+	hooked_live=0;
+	take_and_const(1);
+	check(hooked_live==0);
+	cJSON_InitHooks(&plain);
+}
+
+static void *view_thread(void *arg)
+{
+	return (void*)cJSON_PrintView((cJSON*)arg,0,0);
+}
+
+/* cJSON_PrintView's buffer goes through the hooks when it is cut back, and is freed by a thread that exits without
+   cJSON_ReleasePrintView (LeakSanitizer reports it otherwise). */
+static void test_view(void)
+{
+	char *doc=repeat("{\"id\":12345,\"name\":\"some name\"}",2000);
+	cJSON *big=cJSON_Parse(doc),*small=cJSON_Parse("[1,2,3]");
+	cJSON_Hooks hooks={hooked_malloc,hooked_free},plain={0,0};
+	pthread_t thread;void *out=0;int i,ok=1;
+
+	check(!pthread_create(&thread,0,view_thread,big) && !pthread_join(thread,&out) && out);
+
+	cJSON_InitHooks(&hooks);
+	check(cJSON_PrintView(big,0,0) != 0);
+	for (i=0;i<200;i++) ok&=!strcmp(cJSON_PrintView(small,0,0),"[1,2,3]");
+	check(ok);
+	cJSON_ReleasePrintView();
+	check(hooked_live==0);
+	cJSON_InitHooks(&plain);
+	cJSON_Delete(big);cJSON_Delete(small);free(doc);
+}
+
+int main(void)
+{
+	test_parallel();
+	test_validate();
+	test_tape();
+	test_unshare();
+	test_raw_numbers();
+	test_edit();
+	test_cursor();
+	test_projection();
+	test_writer();
+	test_inline_strings();
+	test_iov();
+	test_framed();
+	test_parse_stats();
+#ifdef cJSON_ALLOC_STATS
+	test_alloc_stats();
+	test_sizer();
+#endif
+#ifdef cJSON_TRACE
+	test_trace();
+#endif
+#ifdef cJSON_PRINT_CACHE
+	test_print_cache();
+#endif
+	test_view();
+	test_take_const();
+	printf("%s: %d checks, %d failed\n",TEST_VARIANT,checks,failures);
+	return failures!=0;
+}